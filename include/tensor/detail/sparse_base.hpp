@@ -23,7 +23,13 @@
 #define TENSOR_DETAIL_SPARSE_BASE_HPP
 
 #include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
 #include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include <tensor/rand.h>
 #include <tensor/detail/common.h>
 
@@ -61,21 +67,6 @@ namespace tensor {
     std::fill(row_start_.begin(), row_start_.end(), 0);
   }
 
-  template<typename elt_t>
-  struct sparse_triplet {
-    index row, col;
-    elt_t value;
-    sparse_triplet() {};
-    sparse_triplet(index r, index c, elt_t v) : row(r), col(c), value(v) {}
-    bool operator<(const sparse_triplet &other) const {
-      if (row < other.row)
-        return 1;
-      if (row == other.row)
-        return col < other.col;
-      return 0;
-    }
-  };
-
   template<typename elt_t>
   Sparse<elt_t>::Sparse(const Indices &dims, const Indices &row_start,
                         const Indices &column, const Tensor<elt_t> &data) :
@@ -84,55 +75,148 @@ namespace tensor {
 	  assert(row_start.size() == dims[0]+1);
   }
 
+#ifndef TENSOR_SPARSE_PARALLEL_SIZE
+#define TENSOR_SPARSE_PARALLEL_SIZE 65536
+#endif
+
+  /* Number of blocks in which we split 'n' elements of a sparse matrix for
+     parallel processing. */
+  static inline int
+  sparse_blocks(index n)
+  {
+#ifdef _OPENMP
+    if (n > TENSOR_SPARSE_PARALLEL_SIZE)
+      return omp_get_max_threads();
+#endif
+    return 1;
+  }
+
+  /* Split the rows of a sparse matrix in consecutive ranges with about the
+     same number of elements. Block b spans the rows [first_row[b],
+     first_row[b+1]). row_start[0] need not be zero, as in a SparseView. */
+  static inline void
+  sparse_row_blocks(const index *row_start, index rows, int blocks,
+                    index *first_row)
+  {
+    const index nonzero = row_start[rows] - row_start[0];
+    for (int b = 0; b < blocks; b++) {
+      first_row[b] = std::lower_bound(row_start, row_start + rows,
+                                      row_start[0] + (nonzero * b) / blocks)
+        - row_start;
+    }
+    first_row[blocks] = rows;
+  }
+
+  /* Stable counting sort of the elements order[0..n) by key[order[i]],
+     with 0 <= key < nkeys. The sorted elements are written to 'output'
+     and, if not null, start[k] is the position of the first element with
+     key k, with start[nkeys] = n. Blocks of the input are counted and
+     scattered in parallel. Each block needs nkeys counters, so there are
+     never more blocks than elements per key. */
+  static inline void
+  sparse_bucket_sort(const index *key, const index *order, index n, index nkeys,
+                     index *output, index *start = 0)
+  {
+    const int blocks = std::min<index>(sparse_blocks(n),
+                                       std::max<index>(1, n / std::max<index>(1, nkeys)));
+    // offset[b*nkeys + k] is where block b writes its next element with key k
+    std::vector<index> offset((size_t)blocks * nkeys, 0);
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      index *count = &offset[(size_t)b * nkeys];
+      for (index i = (n * b) / blocks; i < (n * (b+1)) / blocks; i++)
+        count[key[order[i]]]++;
+    }
+    for (index k = 0, position = 0; k < nkeys; k++) {
+      if (start) start[k] = position;
+      for (int b = 0; b < blocks; b++) {
+        index &p = offset[(size_t)b * nkeys + k];
+        index aux = p;
+        p = position;
+        position += aux;
+      }
+    }
+    if (start) start[nkeys] = n;
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      index *next = &offset[(size_t)b * nkeys];
+      for (index i = (n * b) / blocks; i < (n * (b+1)) / blocks; i++)
+        output[next[key[order[i]]]++] = order[i];
+    }
+  }
+
   template<typename elt_t>
   Sparse<elt_t>::Sparse(const Indices &rows, const Indices &cols, const Tensor<elt_t> &data,
                         index nrows, index ncols) :
     dims_(2), row_start_(), column_(), data_()
   {
-    index i, j, last_row, last_col, l = rows.size();
+    const index l = rows.size();
     assert(cols.size() == l);
     assert(data.size() == l);
-
-    /* Organize data in sparse_triplets (row,column,value), sorted in the
-     * same order in which we store data in Sparse
-     */
-    std::vector<sparse_triplet<elt_t> > sorted_data;
-    sorted_data.reserve(l);
-    for (i = 0; i < l; i++) {
-      index r = rows[i];
-      index c = cols[i];
-      nrows = std::max(nrows, r);
-      ncols = std::max(ncols, c);
-      if (data[i] != number_zero<elt_t>()) {
-        sorted_data.push_back(sparse_triplet<elt_t>(r, c, data[i]));
-      }
+    const index *r = rows.begin();
+    const index *c = cols.begin();
+    const elt_t *v = data.begin();
+    for (index i = 0; i < l; i++) {
+      assert(r[i] >= 0 && c[i] >= 0);
+      nrows = std::max(nrows, r[i] + 1);
+      ncols = std::max(ncols, c[i] + 1);
     }
-    std::sort(sorted_data.begin(), sorted_data.end());
     dims_.at(0) = nrows;
     dims_.at(1) = ncols;
     row_start_ = Indices(nrows+1);
-    column_ = Indices(l = sorted_data.size());
-    data_ = Tensor<elt_t>(l);
 
-    /* Fill in the Sparse structure.
+    /* Sort the elements by column and then, keeping that order, by row.
+     * Each row then lists its elements with growing column index and
+     * repeated elements are next to each other.
      */
-    std::fill(row_start_.begin(), row_start_.end(), 0);
-    for (last_col = 0, last_row = -1, j = i = 0; i < l; i++) {
-      const sparse_triplet<elt_t> &d = sorted_data[i];
-      if (d.row == last_row) {
-        if (d.col == last_col)
-          continue;
-      } else {
-        while(last_row < d.row) {
-          row_start_.at(++last_row) = j;
-        }
+    Indices by_column(l), by_row(l), start(nrows+1);
+    for (index i = 0; i < l; i++)
+      by_column.at(i) = i;
+    sparse_bucket_sort(c, by_column.begin(), l, ncols, by_row.begin());
+    sparse_bucket_sort(r, by_row.begin(), l, nrows, by_column.begin(),
+                       start.begin());
+    const index *order = by_column.begin();
+    const index *row = start.begin();
+
+    /* Sum repeated elements and drop zeros: first count the elements of
+     * each row, then write them.
+     */
+    index *out_row_start = row_start_.begin();
+    const int blocks = sparse_blocks(l);
+#pragma omp parallel for if (blocks > 1)
+    for (index n = 0; n < nrows; n++) {
+      index count = 0;
+      for (index i = row[n]; i < row[n+1]; ) {
+        index col = c[order[i]];
+        elt_t value = v[order[i++]];
+        for (; i < row[n+1] && c[order[i]] == col; i++)
+          value += v[order[i]];
+        if (!(value == number_zero<elt_t>()))
+          count++;
       }
-      column_.at(j) = d.col;
-      data_.at(j) = d.value;
-      j++;
+      out_row_start[n+1] = count;
     }
-    while (last_row < nrows) {
-      row_start_.at(++last_row) = j;
+    out_row_start[0] = 0;
+    for (index n = 0; n < nrows; n++)
+      out_row_start[n+1] += out_row_start[n];
+
+    column_ = Indices(out_row_start[nrows]);
+    data_ = Tensor<elt_t>(out_row_start[nrows]);
+    index *out_column = column_.begin();
+    elt_t *out_data = data_.begin();
+#pragma omp parallel for if (blocks > 1)
+    for (index n = 0; n < nrows; n++) {
+      index j = out_row_start[n];
+      for (index i = row[n]; i < row[n+1]; ) {
+        index col = c[order[i]];
+        elt_t value = v[order[i++]];
+        for (; i < row[n+1] && c[order[i]] == col; i++)
+          value += v[order[i]];
+        if (!(value == number_zero<elt_t>())) {
+          out_column[j] = col;
+          out_data[j++] = value;
+        }
+      }
     }
   }
 
@@ -157,50 +241,91 @@ namespace tensor {
   // CONSTRUCTOR FROM FULL TENSOR TO SPARSE AND VICEVERSA
   //
 
+  /* Whether an element of a tensor is kept in its sparse form. */
   template<typename elt_t>
-  static index
-  number_of_nonzero(const Tensor<elt_t> &data)
+  static inline bool
+  sparse_keep(const elt_t &v, double tolerance)
   {
-    index counter = 0;
-    for (typename Tensor<elt_t>::const_iterator it = data.begin();
-         it != data.end();
-         it++)
-    {
-      if (!(*it == number_zero<elt_t>())) counter++;
-    }
-    return counter;
+    return tolerance? (std::abs(v) > tolerance) : !(v == number_zero<elt_t>());
   }
 
   template<typename elt_t>
-  Sparse<elt_t>::Sparse(const Tensor<elt_t> &t) :
+  Sparse<elt_t>::Sparse(const Tensor<elt_t> &t, double tolerance) :
     dims_(t.dimensions()), row_start_(t.rows()+1),
     column_(), data_()
   {
-    index nonzero = number_of_nonzero<elt_t>(t);
+    const index nrows = rows();
+    const index ncols = columns();
+    const elt_t *p = t.begin();
+    index *row_start = row_start_.begin();
+
+    // Blocks of consecutive rows are scanned column by column, following
+    // the order of the elements in the tensor. The first pass counts the
+    // elements of each row...
+    const int blocks = sparse_blocks(t.size());
+    row_start[0] = 0;
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      const index r0 = (nrows * b) / blocks, r1 = (nrows * (b+1)) / blocks;
+      std::fill(row_start + r0 + 1, row_start + r1 + 1, 0);
+      for (index c = 0; c < ncols; c++) {
+        const elt_t *column = p + c * nrows;
+        for (index r = r0; r < r1; r++) {
+          if (sparse_keep(column[r], tolerance))
+            row_start[r+1]++;
+        }
+      }
+    }
+    for (index r = 0; r < nrows; r++) {
+      row_start[r+1] += row_start[r];
+    }
+
+    // ...and the second one copies them to their place.
+    const index nonzero = row_start[nrows];
     column_ = Indices(nonzero);
     data_ = Tensor<elt_t>(nonzero);
-
-    index nrows = rows();
-    index ncols = columns();
-
-    Indices::iterator row_it = row_start_.begin();
-    Indices::iterator col_it = column_.begin();
-    Indices::iterator col_begin = col_it;
-    typename Tensor<elt_t>::iterator data_it = data_.begin();
-
-    *(row_it++) = 0;
-    for (index r = 0; r < nrows; r++) {
+    index *out_column = column_.begin();
+    elt_t *out_data = data_.begin();
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      const index r0 = (nrows * b) / blocks, r1 = (nrows * (b+1)) / blocks;
+      std::vector<index> next(row_start + r0, row_start + r1);
       for (index c = 0; c < ncols; c++) {
-        elt_t v = t(r,c);
-        if (!(v == number_zero<elt_t>())) {
-          *(data_it++) = v;
-          *(col_it++) = c;
+        const elt_t *column = p + c * nrows;
+        for (index r = r0; r < r1; r++) {
+          if (sparse_keep(column[r], tolerance)) {
+            index x = next[r - r0]++;
+            out_column[x] = c;
+            out_data[x] = column[r];
+          }
         }
       }
-      *(row_it++) = col_it - col_begin;
     }
   }
 
+  template<typename elt_t>
+  Sparse<elt_t>::Sparse(const SparseView<elt_t> &v) :
+    dims_(v.dimensions()), row_start_(v.priv_row_start()),
+    column_(v.priv_column()), data_(v.priv_data())
+  {
+    const index nrows = rows();
+    const index first = row_start_[0];
+    const index nonzero = row_start_[nrows] - first;
+    if (nonzero == (index)column_.size())
+      return;
+    // Only a part of the parent is used: copy it and shift the offsets
+    Indices row_start(nrows + 1);
+    for (index r = 0; r <= nrows; r++)
+      row_start.at(r) = row_start_[r] - first;
+    row_start_ = row_start;
+    column_ = Indices(nonzero);
+    data_ = Tensor<elt_t>(nonzero);
+    std::copy(v.priv_column().begin() + first,
+              v.priv_column().begin() + first + nonzero, column_.begin());
+    std::copy(v.priv_data().begin() + first,
+              v.priv_data().begin() + first + nonzero, data_.begin());
+  }
+
   template<typename elt_t>
   const Tensor<elt_t> full(const Sparse<elt_t> &s)
   {
@@ -208,15 +333,27 @@ namespace tensor {
     index ncols = s.columns();
     Tensor<elt_t> output(nrows, ncols);
     if (nrows && ncols) {
-      output.fill_with_zeros();
-
-      Indices::const_iterator row_start = s.priv_row_start().begin();
-      Indices::const_iterator column = s.priv_column().begin();
-      typename Tensor<elt_t>::const_iterator data = s.priv_data().begin();
-
-      for (index i = 0; i < nrows; i++) {
-        for (index l = row_start[i+1] - row_start[i]; l; l--) {
-          output.at(i, *(column++)) = *(data++);
+      const index size = nrows * ncols;
+      const index *row_start = s.priv_row_start().begin();
+      const index *column = s.priv_column().begin();
+      const elt_t *data = s.priv_data().begin();
+      elt_t *out = output.begin();
+
+      const int blocks = sparse_blocks(size);
+#pragma omp parallel for if (blocks > 1)
+      for (int b = 0; b < blocks; b++) {
+        std::fill(out + (size * b) / blocks, out + (size * (b+1)) / blocks,
+                  number_zero<elt_t>());
+      }
+      // Each thread writes the elements of different rows
+      std::vector<index> first_row(blocks + 1);
+      sparse_row_blocks(row_start, nrows, blocks, &first_row[0]);
+#pragma omp parallel for if (blocks > 1)
+      for (int b = 0; b < blocks; b++) {
+        for (index i = first_row[b]; i < first_row[b+1]; i++) {
+          for (index x = row_start[i]; x < row_start[i+1]; x++) {
+            out[i + nrows * column[x]] = data[x];
+          }
         }
       }
     }
@@ -251,6 +388,50 @@ namespace tensor {
                   data);
   }
 
+  template<typename elt_t> Sparse<elt_t>
+  Sparse<elt_t>::diag(const Tensor<elt_t> &d, int which, index rows, index columns)
+  {
+    index r0 = (which < 0)? -which : 0;
+    index c0 = (which < 0)? 0 : which;
+    index l = std::min<index>(rows - r0, columns - c0);
+    if (l < 0) {
+      std::cerr << "In Sparse::diag(d,which,...) the value of WHICH exceeds the size of the matrix"
+                << std::endl;
+      abort();
+    }
+    if (l != (index)d.size()) {
+      std::cerr << "In Sparse::diag(d,...) the vector D has too few/many elements."
+                << std::endl;
+      abort();
+    }
+    index nonzero = 0;
+    for (index k = 0; k < l; k++) {
+      if (d[k] != number_zero<elt_t>())
+        nonzero++;
+    }
+    Indices row_start(rows+1);
+    Indices column(nonzero);
+    Tensor<elt_t> data(nonzero);
+    row_start.at(0) = 0;
+    for (index i = 0, n = 0; i < rows; i++) {
+      index k = i - r0;
+      if (k >= 0 && k < l && d[k] != number_zero<elt_t>()) {
+        column.at(n) = c0 + k;
+        data.at(n) = d[k];
+        n++;
+      }
+      row_start.at(i+1) = n;
+    }
+    return Sparse(igen << rows << columns, row_start, column, data);
+  }
+
+  template<typename elt_t> Sparse<elt_t>
+  Sparse<elt_t>::diag(const Tensor<elt_t> &d, int which)
+  {
+    index n = d.size() + std::abs(which);
+    return diag(d, which, n, n);
+  }
+
   template<typename elt_t> Sparse<elt_t>
   Sparse<elt_t>::random(index rows, index columns, double density)
   {
@@ -290,6 +471,165 @@ namespace tensor {
     return number_zero<elt_t>();
   }
 
+  //////////////////////////////////////////////////////////////////////
+  // INCREMENTAL CONSTRUCTION
+  //
+
+  static inline size_t
+  sparse_hash(index row, index col)
+  {
+    size_t h = (size_t)row * 2654435761u ^ (size_t)col;
+    h ^= h >> 15;
+    h *= 2246822519u;
+    h ^= h >> 13;
+    return h;
+  }
+
+  /* Number of the calling thread within the only enclosing OpenMP team
+     that has more than one thread, or -1 if there are several such teams,
+     in which case the thread numbers are not unique. */
+  static inline int
+  sparse_thread()
+  {
+#ifdef _OPENMP
+    int thread = 0, teams = 0;
+    for (int level = omp_get_level(); level > 0; level--) {
+      if (omp_get_team_size(level) > 1) {
+        thread = omp_get_ancestor_thread_num(level);
+        teams++;
+      }
+    }
+    return (teams > 1)? -1 : thread;
+#else
+    return 0;
+#endif
+  }
+
+  template<typename elt_t>
+  SparseBuilder<elt_t>::SparseBuilder(index rows, index cols) :
+    rows_(rows), cols_(cols),
+#ifdef _OPENMP
+    tables_(omp_get_max_threads())
+#else
+    tables_(1)
+#endif
+  {
+    assert(rows >= 0 && cols >= 0);
+  }
+
+  template<typename elt_t>
+  void SparseBuilder<elt_t>::table_t::grow()
+  {
+    std::vector<index> old_row, old_column;
+    std::vector<elt_t> old_data;
+    old_row.swap(row);
+    old_column.swap(column);
+    old_data.swap(data);
+    size_t capacity = std::max<size_t>(16, 2 * old_row.size());
+    row.resize(capacity, -1);
+    column.resize(capacity);
+    data.resize(capacity);
+    size_t mask = capacity - 1;
+    for (size_t j = 0; j < old_row.size(); j++) {
+      if (old_row[j] >= 0) {
+        size_t i = sparse_hash(old_row[j], old_column[j]) & mask;
+        while (row[i] >= 0)
+          i = (i + 1) & mask;
+        row[i] = old_row[j];
+        column[i] = old_column[j];
+        data[i] = old_data[j];
+      }
+    }
+  }
+
+  template<typename elt_t>
+  void SparseBuilder<elt_t>::table_t::add(index r, index c, elt_t v)
+  {
+    /* We keep the load factor below 1/2 */
+    if ((size_t)(2 * (size + 1)) > row.size())
+      grow();
+    size_t mask = row.size() - 1;
+    for (size_t i = sparse_hash(r, c) & mask; ; i = (i + 1) & mask) {
+      if (row[i] < 0) {
+        row[i] = r;
+        column[i] = c;
+        data[i] = v;
+        size++;
+        return;
+      }
+      if (row[i] == r && column[i] == c) {
+        data[i] += v;
+        return;
+      }
+    }
+  }
+
+  template<typename elt_t>
+  void SparseBuilder<elt_t>::add(index row, index col, elt_t value)
+  {
+    assert(row >= 0 && row < rows_);
+    assert(col >= 0 && col < cols_);
+    int t = sparse_thread();
+    if (t < 0) {
+      std::cerr << "SparseBuilder::add() called from nested parallel regions "
+        "with more than one thread." << std::endl;
+      abort();
+    }
+    if ((size_t)t >= tables_.size()) {
+      std::cerr << "SparseBuilder::add() called from more threads than were "
+        "available when the builder was created." << std::endl;
+      abort();
+    }
+    tables_[t].add(row, col, value);
+  }
+
+  template<typename elt_t>
+  index SparseBuilder<elt_t>::length() const
+  {
+    index output = 0;
+    for (size_t t = 0; t < tables_.size(); t++)
+      output += tables_[t].size;
+    return output;
+  }
+
+  template<typename elt_t>
+  void SparseBuilder<elt_t>::clear()
+  {
+    for (size_t t = 0; t < tables_.size(); t++)
+      tables_[t] = table_t();
+  }
+
+  template<typename elt_t>
+  Sparse<elt_t> SparseBuilder<elt_t>::finalize()
+  {
+    /* Each table is dumped to a different segment of the coordinate
+     * arrays and released. The Sparse constructor then sorts the elements
+     * and adds those that were found in more than one table.
+     */
+    const int n = tables_.size();
+    std::vector<index> offset(n + 1, 0);
+    for (int t = 0; t < n; t++)
+      offset[t+1] = offset[t] + tables_[t].size;
+    Indices rows(offset[n]), cols(offset[n]);
+    Tensor<elt_t> data(offset[n]);
+    index *pr = rows.begin();
+    index *pc = cols.begin();
+    elt_t *pd = data.begin();
+#pragma omp parallel for if (offset[n] > TENSOR_SPARSE_PARALLEL_SIZE)
+    for (int t = 0; t < n; t++) {
+      table_t &table = tables_[t];
+      for (size_t i = 0, j = offset[t]; i < table.row.size(); i++) {
+        if (table.row[i] >= 0) {
+          pr[j] = table.row[i];
+          pc[j] = table.column[i];
+          pd[j++] = table.data[i];
+        }
+      }
+      table = table_t();
+    }
+    return Sparse<elt_t>(rows, cols, data, rows_, cols_);
+  }
+
 } // namespace tensor
 
 #endif // !TENSOR_DETAIL_SPARSE_BASE_HPP
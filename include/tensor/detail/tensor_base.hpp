@@ -207,6 +207,15 @@ void Tensor<elt_t>::reshape(const Indices &new_dimensions)
   dims_ = new_dimensions;
 }
 
+template<typename elt_t>
+void Tensor<elt_t>::resize(const Indices &new_dimensions)
+{
+  index new_size = new_dimensions.total_size();
+  if (new_size != size() || data_.ref_count() > 1)
+    data_ = Vector<elt_t>(new_size);
+  dims_ = new_dimensions;
+}
+
 //
 // GETTERS
 //
@@ -58,6 +58,9 @@ namespace linalg {
   /**Solve a real linear system of equations by the conjugate gradient method.*/
   const CTensor cgs(const RSparse &A, const CTensor &b, const CTensor *x_start = 0,
                     int maxiter = 0, double tol = 0);
+  /**Solve a complex linear system of equations by the conjugate gradient method.*/
+  const CTensor cgs(const CSparse &A, const CTensor &b, const CTensor *x_start = 0,
+                    int maxiter = 0, double tol = 0);
 
   /**Solve a real linear system of equations by the conjugate gradient
      method. 'f' is a function that takes in a Tensor and returns also a Tensor
@@ -74,6 +77,8 @@ namespace linalg {
   #define SVD_ECONOMIC true
   RTensor svd(RTensor A, RTensor *pU = 0, RTensor *pVT = 0, bool economic = 0);
   RTensor svd(CTensor A, CTensor *pU = 0, CTensor *pVT = 0, bool economic = 0);
+  void svd_into(RTensor &s, RTensor A, RTensor *pU = 0, RTensor *pVT = 0, bool economic = 0);
+  void svd_into(RTensor &s, CTensor A, CTensor *pU = 0, CTensor *pVT = 0, bool economic = 0);
 
   RTensor block_svd(RTensor A, RTensor *pU = 0, RTensor *pVT = 0, bool economic = 0);
   RTensor block_svd(CTensor A, CTensor *pU = 0, CTensor *pVT = 0, bool economic = 0);
@@ -134,6 +139,8 @@ namespace linalg {
 
   RTensor eig_sym(const RTensor &A, RTensor *pR = 0);
   RTensor eig_sym(const CTensor &A, CTensor *pR = 0);
+  void eig_sym_into(RTensor &output, const RTensor &A, RTensor *pR = 0);
+  void eig_sym_into(RTensor &output, const CTensor &A, CTensor *pR = 0);
 
   const RTensor expm(const RTensor &A, unsigned int order = 7);
   const CTensor expm(const CTensor &A, unsigned int order = 7);
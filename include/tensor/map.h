@@ -20,6 +20,7 @@
 #ifndef TENSOR_MAP_H
 #define TENSOR_MAP_H
 
+#include <vector>
 #include <tensor/tensor.h>
 #include <tensor/sparse.h>
 
@@ -31,9 +32,12 @@ namespace tensor {
     virtual const Tensor operator()(const Tensor &arg) const { return arg; };
   };
 
-  template<class Matrix>
-  struct MatrixMap : public Map<Tensor<typename Matrix::elt_t> > {
-    typedef Tensor<typename Matrix::elt_t> tensor_t;
+  /**Linear map given by a matrix. The tensors it acts upon may be complex
+     when the matrix is real, as in MatrixMap<RSparse,CTensor>, which
+     multiplies them without converting the matrix.*/
+  template<class Matrix, class tensor_type = Tensor<typename Matrix::elt_t> >
+  struct MatrixMap : public Map<tensor_type> {
+    typedef tensor_type tensor_t;
     MatrixMap(const Matrix &m, bool transpose = false);
     virtual ~MatrixMap();
     virtual const tensor_t operator()(const tensor_t &arg) const;
@@ -42,6 +46,30 @@ namespace tensor {
     const bool transpose_;
   };
 
+  /**Linear map for a sum of Kronecker products, kron(A1,B1)+kron(A2,B2)+...
+     The products are never built: each term is applied to a vector x of
+     size A.columns()*B.columns() as B * reshape(x) * transpose(A), using
+     the memory of the factors only. Matrices are processed column by
+     column. The object is also a function that
+     can be passed to linalg::eigs(), linalg::cgs() or linalg::eig_power(). */
+  template<class Matrix>
+  struct KronMap : public Map<Tensor<typename Matrix::elt_t> > {
+    typedef Tensor<typename Matrix::elt_t> tensor_t;
+    KronMap(const Matrix &A, const Matrix &B);
+    virtual ~KronMap();
+    /**Add the term kron(A,B).*/
+    void add(const Matrix &A, const Matrix &B);
+    /**Number of rows of the operator.*/
+    index rows() const { return a_rows_ * b_rows_; }
+    /**Number of columns of the operator.*/
+    index columns() const { return a_cols_ * b_cols_; }
+    virtual const tensor_t operator()(const tensor_t &arg) const;
+  private:
+    const tensor_t apply_vector(const tensor_t &x) const;
+    std::vector<Matrix> At_, B_;
+    index a_rows_, a_cols_, b_rows_, b_cols_;
+  };
+
   template<class Func, class Tensor>
   struct FunctionMap : public Map<Tensor> {
     FunctionMap(const Func &f) : f_(f) {}
@@ -162,6 +190,13 @@ namespace tensor {
   extern template class MatrixMap<CTensor>;
   extern template class MatrixMap<RSparse>;
   extern template class MatrixMap<CSparse>;
+  extern template class MatrixMap<RSparse, CTensor>;
+  extern template class MatrixMap<RHermitianSparse>;
+  extern template class MatrixMap<CHermitianSparse>;
+  extern template class KronMap<RTensor>;
+  extern template class KronMap<CTensor>;
+  extern template class KronMap<RSparse>;
+  extern template class KronMap<CSparse>;
 
 } // namespace tensor
 
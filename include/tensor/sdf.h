@@ -24,6 +24,7 @@
 #include <string>
 #include <vector>
 #include <tensor/tensor.h>
+#include <tensor/sparse.h>
 
 namespace sdf {
 
@@ -42,7 +43,9 @@ namespace sdf {
       TAG_RTENSOR = 0,
       TAG_CTENSOR = 1,
       TAG_RTENSOR_VECTOR = 2,
-      TAG_CTENSOR_VECTOR = 3
+      TAG_CTENSOR_VECTOR = 3,
+      TAG_RSPARSE = 4,
+      TAG_CSPARSE = 5
     };
 
     enum endianness {
@@ -93,6 +96,8 @@ namespace sdf {
     void dump(const CTensor &t, const std::string &name = "");
     void dump(const std::vector<RTensor> &t, const std::string &name = "");
     void dump(const std::vector<CTensor> &t, const std::string &name = "");
+    void dump(const RSparse &s, const std::string &name = "");
+    void dump(const CSparse &s, const std::string &name = "");
 
     void close();
 
@@ -112,6 +117,7 @@ namespace sdf {
     }
 
     template<class Vector> void dump_vector(const Vector &v);
+    template<class Sparse> void dump_sparse(const Sparse &s);
 
     void write_header();
     void write_variable_name(const std::string &name);
@@ -132,6 +138,8 @@ namespace sdf {
     void load(CTensor *t, const std::string &name = "");
     void load(std::vector<RTensor> *m, const std::string &name = "");
     void load(std::vector<CTensor> *m, const std::string &name = "");
+    void load(RSparse *s, const std::string &name = "");
+    void load(CSparse *s, const std::string &name = "");
 
     void close();
 
@@ -151,6 +159,7 @@ namespace sdf {
     }
 
     template<class Vector> const Vector load_vector();
+    template<class Sparse> const Sparse load_sparse();
 
     tensor::index read_tag_code();
     std::string read_variable_name();
@@ -21,10 +21,13 @@
 #ifndef TENSOR_SPARSE_H
 #define TENSOR_SPARSE_H
 
+#include <vector>
 #include <tensor/tensor.h>
 
 namespace tensor {
 
+  template<typename elt> class SparseView;
+
   /**A sparse matrix. A sparse matrix is a compact representation of
      two-dimensional tensors that have a lot of zero elements. Our
      implementation behaves much like Matlab's sparse matrices, in the sense
@@ -43,15 +46,20 @@ namespace tensor {
     Sparse();
     /**Create a matrix with all elements set to zero.*/
     Sparse(index rows, index cols, index nonzero = 0);
-    /**Create a sparse matrix from the coordinates and values. */
+    /**Create a sparse matrix from the coordinates and values. Elements
+       with the same coordinates are added and zeros are dropped. */
     Sparse(const Indices &row_indices, const Indices &column_indices,
            const Tensor<elt_t> &data,
            index rows = 0, index columns = 0);
     /* Create a sparse matrix from its internal representation. */
     Sparse(const Indices &dims, const Indices &row_start,
            const Indices &column, const Tensor<elt_t> &data);
-    /**Convert a tensor to sparse form.*/
-    explicit Sparse(const Tensor<elt_t> &tensor);
+    /**Convert a tensor to sparse form, dropping the elements whose absolute
+       value does not exceed the tolerance. With the default tolerance only
+       exact zeros are dropped.*/
+    explicit Sparse(const Tensor<elt_t> &tensor, double tolerance = 0.0);
+    /**Copy the rows of a SparseView into a new matrix.*/
+    explicit Sparse(const SparseView<elt_t> &view);
     /**Copy constructor.*/
     Sparse(const Sparse<elt_t> &s);
     /**Assignment operator.*/
@@ -83,6 +91,10 @@ namespace tensor {
     static Sparse<elt_t> eye(index rows, index cols);
     /**Identity matrix in sparse form.*/
     static Sparse<elt_t> eye(index rows) { return eye(rows,rows); }
+    /**Sparse matrix with the vector d on the given diagonal.*/
+    static Sparse<elt_t> diag(const Tensor<elt_t> &d, int which, index rows, index cols);
+    /**Sparse square matrix with the vector d on the given diagonal.*/
+    static Sparse<elt_t> diag(const Tensor<elt_t> &d, int which = 0);
     /**Return a random sparse matrix.*/
     static Sparse<elt_t> random(index rows, index columns, double density = 0.2);
 
@@ -106,6 +118,338 @@ namespace tensor {
 
   typedef Sparse<double> RSparse;
   typedef Sparse<cdouble> CSparse;
+
+  /**Consecutive rows [first, last) of a sparse matrix. The view does not
+     copy the matrix: it shares the column indices and values of its parent
+     and only keeps the offsets of its rows, so that large operators can be
+     split among threads or processes without duplicating them. Use
+     Sparse(view) to obtain an independent matrix.
+
+     \ingroup Tensors
+  */
+  template<typename elt>
+  class SparseView {
+  public:
+    typedef elt elt_t;
+
+    /**View of the rows [first, last) of a sparse matrix.*/
+    SparseView(const Sparse<elt_t> &s, index first, index last);
+
+    /**Matrix dimensions.*/
+    const Indices &dimensions() const { return dims_; }
+    /**Number of rows.*/
+    index rows() const { return dims_[0]; }
+    /**Number of columns.*/
+    index columns() const { return dims_[1]; }
+    /**Number of nonzero elements.*/
+    index length() const { return row_start_[rows()] - row_start_[0]; }
+    /**Row of the parent matrix where the view starts.*/
+    index first_row() const { return first_; }
+
+    /**Return an element of the view.*/
+    elt_t operator()(index row, index col) const;
+
+    /* Row offsets refer to the column indices and values of the parent. */
+    const Indices &priv_row_start() const { return row_start_; }
+    const Indices &priv_column() const { return column_; }
+    const Tensor<elt> &priv_data() const { return data_; }
+
+  private:
+    Indices dims_;
+    index first_;
+    Indices row_start_;
+    Indices column_;
+    Tensor<elt_t> data_;
+  };
+
+  typedef SparseView<double> RSparseView;
+  typedef SparseView<cdouble> CSparseView;
+
+  /**Linear combination c[0]*S[0] + c[1]*S[1] + ... of sparse matrices with
+     fixed sparsity patterns, such as a time dependent operator
+     H(t) = H0 + f(t) H1. The pattern of the sum is built once, together with
+     the position of every element of each term in it, so that each new set
+     of coefficients only computes values. All the matrices returned share
+     the same row and column structure.
+
+     \ingroup Tensors
+  */
+  template<typename elt>
+  class SparseCombination {
+  public:
+    typedef elt elt_t;
+
+    /**Combination with a single term.*/
+    explicit SparseCombination(const Sparse<elt_t> &S0);
+    /**Combination of two terms.*/
+    SparseCombination(const Sparse<elt_t> &S0, const Sparse<elt_t> &S1);
+
+    /**Add a new term, which must have the same dimensions.*/
+    void add(const Sparse<elt_t> &S);
+    /**Number of terms.*/
+    index terms() const { return terms_.size(); }
+
+    /**Return the sum of all terms, each one multiplied by the coefficient
+       c[n] with the same position.*/
+    const Sparse<elt_t> operator()(const Tensor<elt_t> &c) const;
+    /**Return c0 * S[0] + c1 * S[1] for a combination of two terms.*/
+    const Sparse<elt_t> operator()(elt_t c0, elt_t c1) const;
+
+  private:
+    Indices dims_, row_start_, column_;
+    std::vector<Sparse<elt_t> > terms_;
+    /** Position of each element of every term in column_. */
+    std::vector<Indices> positions_;
+  };
+
+  typedef SparseCombination<double> RSparseCombination;
+  typedef SparseCombination<cdouble> CSparseCombination;
+
+  /**Incremental construction of a sparse matrix. Elements are added one by
+     one with add() and finalize() produces the Sparse matrix. Elements with
+     the same coordinates are added together as they arrive, so that repeated
+     contributions do not take more memory.
+
+     The method add() may be called concurrently from the threads of an
+     OpenMP parallel region: each thread accumulates into its own hash table,
+     and finalize() merges them in O(nnz) time. Nested regions are allowed
+     as long as only one of them has more than one thread; otherwise add()
+     aborts. Threads not created by OpenMP must not call add() concurrently,
+     as they would all share the same table.
+
+     \ingroup Tensors
+  */
+  template<typename elt>
+  class SparseBuilder {
+  public:
+    typedef elt elt_t;
+
+    /**Start building a matrix with the given dimensions.*/
+    SparseBuilder(index rows, index cols);
+
+    /**Add 'value' to the element at (row,col).*/
+    void add(index row, index col, elt_t value);
+    /**Produce the sparse matrix and leave the builder empty.*/
+    Sparse<elt_t> finalize();
+    /**Discard all elements.*/
+    void clear();
+
+    /**Number of rows.*/
+    index rows() const { return rows_; }
+    /**Number of columns.*/
+    index columns() const { return cols_; }
+    /**Number of stored elements, which may count repeated coordinates once
+       per thread.*/
+    index length() const;
+
+  private:
+    /* Open addressing hash table with linear probing. An empty slot has
+       row < 0. It is padded to avoid false sharing between threads. */
+    struct table_t {
+      std::vector<index> row, column;
+      std::vector<elt_t> data;
+      index size;
+      char padding[64];
+
+      table_t() : row(), column(), data(), size(0), padding() {}
+      void add(index r, index c, elt_t v);
+      void grow();
+    };
+
+    index rows_, cols_;
+    std::vector<table_t> tables_;
+  };
+
+  typedef SparseBuilder<double> RSparseBuilder;
+  typedef SparseBuilder<cdouble> CSparseBuilder;
+
+  /**Sparse matrix in block compressed row (BSR) format. The matrix is
+     divided in square blocks of a fixed size and only the blocks with some
+     nonzero element are stored, as dense column-major matrices in the order
+     of a CSR matrix. For operators whose elements come in dense sub-blocks
+     this saves most column indices and lets mmult() work on whole blocks.
+
+     \ingroup Tensors
+  */
+  template<typename elt>
+  class BlockSparse {
+  public:
+    typedef elt elt_t;
+
+    /**Build an empty matrix.*/
+    BlockSparse();
+    /**Convert a sparse matrix, using blocks of size block x block.*/
+    explicit BlockSparse(const Sparse<elt_t> &s, index block = 4);
+
+    /**Matrix dimensions.*/
+    const Indices &dimensions() const { return dims_; }
+    /**Number of rows.*/
+    index rows() const { return dims_[0]; }
+    /**Number of columns.*/
+    index columns() const { return dims_[1]; }
+    /**Number of rows and columns of each block.*/
+    index block_size() const { return block_; }
+    /**Number of stored blocks.*/
+    index length() const { return block_column_.size(); }
+
+    const Indices &priv_block_row_start() const { return block_row_start_; }
+    const Indices &priv_block_column() const { return block_column_; }
+    const Tensor<elt> &priv_data() const { return data_; }
+
+  private:
+    Indices dims_;
+    index block_;
+    /** For each row of blocks, where its entries start in block_column_. */
+    Indices block_row_start_;
+    /** Column of each stored block, in units of blocks. */
+    Indices block_column_;
+    /** Elements of the blocks, each one a block x block column-major matrix. */
+    Tensor<elt_t> data_;
+  };
+
+  /**Hermitian (or real symmetric) sparse matrix that stores only its upper
+     triangle, diagonal included, in CSR format. mmult() applies the stored
+     elements and their adjoints in a single pass over the data, so that the
+     product reads half as much memory as with the full Sparse matrix. It
+     can be used with MatrixMap and thus with linalg::eigs() or linalg::cgs().
+
+     \ingroup Tensors
+  */
+  template<typename elt>
+  class HermitianSparse {
+  public:
+    typedef elt elt_t;
+
+    /**Build an empty matrix.*/
+    HermitianSparse();
+    /**Keep the upper triangle of a square sparse matrix, which is assumed
+       to be Hermitian. The lower triangle is ignored.*/
+    explicit HermitianSparse(const Sparse<elt_t> &s);
+
+    /**Matrix dimensions.*/
+    const Indices &dimensions() const { return dims_; }
+    /**Number of rows.*/
+    index rows() const { return dims_[0]; }
+    /**Number of columns.*/
+    index columns() const { return dims_[1]; }
+    /**Number of stored elements.*/
+    index length() const { return column_.size(); }
+
+    const Indices &priv_row_start() const { return row_start_; }
+    const Indices &priv_column() const { return column_; }
+    const Tensor<elt> &priv_data() const { return data_; }
+
+  private:
+    Indices dims_;
+    Indices row_start_;
+    Indices column_;
+    Tensor<elt_t> data_;
+  };
+
+  typedef HermitianSparse<double> RHermitianSparse;
+  typedef HermitianSparse<cdouble> CHermitianSparse;
+
+  /**Column indices of 32 bits, used by the sparse formats meant for fast
+     products.*/
+  typedef Vector<int> CompactIndices;
+
+  /**Sparse matrix in CSR format with 32-bit column indices. It shares the
+     row structure and the values of the Sparse matrix it is built from and
+     only keeps its own compact copy of the column indices, which reduces
+     the memory traffic of mmult(). The matrix must have less than 2^31
+     columns.
+
+     \ingroup Tensors
+  */
+  template<typename elt>
+  class CompactSparse {
+  public:
+    typedef elt elt_t;
+
+    /**Build an empty matrix.*/
+    CompactSparse();
+    /**Convert a sparse matrix.*/
+    explicit CompactSparse(const Sparse<elt_t> &s);
+
+    /**Matrix dimensions.*/
+    const Indices &dimensions() const { return dims_; }
+    /**Number of rows.*/
+    index rows() const { return dims_[0]; }
+    /**Number of columns.*/
+    index columns() const { return dims_[1]; }
+    /**Number of nonzero elements.*/
+    index length() const { return column_.size(); }
+
+    const Indices &priv_row_start() const { return row_start_; }
+    const CompactIndices &priv_column() const { return column_; }
+    const Tensor<elt> &priv_data() const { return data_; }
+
+  private:
+    Indices dims_;
+    Indices row_start_;
+    CompactIndices column_;
+    Tensor<elt_t> data_;
+  };
+
+  typedef CompactSparse<double> RCompactSparse;
+  typedef CompactSparse<cdouble> CCompactSparse;
+
+  typedef BlockSparse<double> RBlockSparse;
+  typedef BlockSparse<cdouble> CBlockSparse;
+
+  /**Sparse matrix in SELL-C-sigma format. Rows are sorted by decreasing
+     number of elements within windows of 'sigma' rows and grouped in chunks
+     of 'C' rows. Each chunk is padded to the length of its longest row and
+     stored column by column, so that mmult() processes the rows of a chunk
+     together with SIMD instructions. With sigma = 1 this is ELLPACK applied
+     chunk by chunk. Column indices take 32 bits, so that the matrix must
+     have less than 2^31 columns.
+
+     \ingroup Tensors
+  */
+  template<typename elt>
+  class SlicedSparse {
+  public:
+    typedef elt elt_t;
+
+    /**Build an empty matrix.*/
+    SlicedSparse();
+    /**Convert a sparse matrix, using chunks of 'chunk' rows that are sorted
+       within windows of 'sigma' rows.*/
+    explicit SlicedSparse(const Sparse<elt_t> &s, index chunk = 8,
+                          index sigma = 256);
+
+    /**Matrix dimensions.*/
+    const Indices &dimensions() const { return dims_; }
+    /**Number of rows.*/
+    index rows() const { return dims_[0]; }
+    /**Number of columns.*/
+    index columns() const { return dims_[1]; }
+    /**Number of rows in a chunk.*/
+    index chunk_size() const { return chunk_; }
+    /**Number of stored elements, including the padding.*/
+    index length() const { return column_.size(); }
+
+    const Indices &priv_row() const { return row_; }
+    const Indices &priv_chunk_start() const { return chunk_start_; }
+    const CompactIndices &priv_column() const { return column_; }
+    const Tensor<elt> &priv_data() const { return data_; }
+
+  private:
+    Indices dims_;
+    index chunk_;
+    /** Original row of every sorted row. */
+    Indices row_;
+    /** Where each chunk starts in column_ and data_. */
+    Indices chunk_start_;
+    /** Column of every element, with padding elements in column 0. */
+    CompactIndices column_;
+    /** Values of the elements, zero for the padding. */
+    Tensor<elt_t> data_;
+  };
+
+  typedef SlicedSparse<double> RSlicedSparse;
+  typedef SlicedSparse<cdouble> CSlicedSparse;
   const CSparse to_complex(const RSparse &s);
   inline const CSparse to_complex(const CSparse &c) { return c; }
 
@@ -148,6 +492,46 @@ namespace tensor {
   const RTensor mmult(const RSparse &m1, const RTensor &m2);
   /* Matrix multiplication between tensor and sparse matrix. */
   const CTensor mmult(const CSparse &m1, const CTensor &m2);
+  /**Product of a complex tensor and a real sparse matrix, which is not
+     converted to complex form.*/
+  const CTensor mmult(const CTensor &m1, const RSparse &m2);
+  /**Product of a real sparse matrix and a complex tensor, which is not
+     converted to complex form.*/
+  const CTensor mmult(const RSparse &m1, const CTensor &m2);
+
+  /**Matrix multiplication between sparse matrices.*/
+  const RSparse mmult(const RSparse &m1, const RSparse &m2);
+  /**Matrix multiplication between sparse matrices.*/
+  const CSparse mmult(const CSparse &m1, const CSparse &m2);
+  /**Matrix multiplication between sparse matrices.*/
+  const CSparse mmult(const RSparse &m1, const CSparse &m2);
+  /**Matrix multiplication between sparse matrices.*/
+  const CSparse mmult(const CSparse &m1, const RSparse &m2);
+
+  /* Matrix multiplication between block sparse matrix and tensor. */
+  const RTensor mmult(const RBlockSparse &m1, const RTensor &m2);
+  /* Matrix multiplication between block sparse matrix and tensor. */
+  const CTensor mmult(const CBlockSparse &m1, const CTensor &m2);
+  /* Matrix multiplication between SELL-C-sigma matrix and tensor. */
+  const RTensor mmult(const RSlicedSparse &m1, const RTensor &m2);
+  /* Matrix multiplication between SELL-C-sigma matrix and tensor. */
+  const CTensor mmult(const CSlicedSparse &m1, const CTensor &m2);
+  /* Matrix multiplication between Hermitian sparse matrix and tensor. */
+  const RTensor mmult(const RHermitianSparse &m1, const RTensor &m2);
+  /* Matrix multiplication between Hermitian sparse matrix and tensor. */
+  const CTensor mmult(const CHermitianSparse &m1, const CTensor &m2);
+  /* Matrix multiplication between tensor and Hermitian sparse matrix. */
+  const RTensor mmult(const RTensor &m1, const RHermitianSparse &m2);
+  /* Matrix multiplication between tensor and Hermitian sparse matrix. */
+  const CTensor mmult(const CTensor &m1, const CHermitianSparse &m2);
+  /* Matrix multiplication between compact sparse matrix and tensor. */
+  const RTensor mmult(const RCompactSparse &m1, const RTensor &m2);
+  /* Matrix multiplication between compact sparse matrix and tensor. */
+  const CTensor mmult(const CCompactSparse &m1, const CTensor &m2);
+  /* Matrix multiplication between tensor and compact sparse matrix. */
+  const RTensor mmult(const RTensor &m1, const RCompactSparse &m2);
+  /* Matrix multiplication between tensor and compact sparse matrix. */
+  const CTensor mmult(const CTensor &m1, const CCompactSparse &m2);
 
   /* Real part of a sparse matrix.*/
   inline const RSparse &real(const RSparse &A) { return A; }
@@ -196,6 +580,104 @@ namespace tensor {
   const CSparse operator/(const RSparse &a, cdouble b);
   const CSparse operator*(cdouble a, const RSparse &b);
 
+  /**Multiply a view of a sparse matrix with a tensor, contracting the first
+     index of the tensor.*/
+  const RTensor mmult(const RSparseView &m1, const RTensor &m2);
+  /**Multiply a view of a sparse matrix with a tensor, contracting the first
+     index of the tensor.*/
+  const CTensor mmult(const CSparseView &m1, const CTensor &m2);
+  /**Multiply a tensor with a view of a sparse matrix, contracting the last
+     index of the tensor.*/
+  const RTensor mmult(const RTensor &m1, const RSparseView &m2);
+  /**Multiply a tensor with a view of a sparse matrix, contracting the last
+     index of the tensor.*/
+  const CTensor mmult(const CTensor &m1, const CSparseView &m2);
+
+  /**Return the rows of a sparse matrix in the given order, which may
+     repeat rows.*/
+  const RSparse take_rows(const RSparse &s, const Indices &rows);
+  /**Return the rows of a sparse matrix in the given order, which may
+     repeat rows.*/
+  const CSparse take_rows(const CSparse &s, const Indices &rows);
+  /**Return the columns of a sparse matrix in the given order, which may
+     repeat columns.*/
+  const RSparse take_columns(const RSparse &s, const Indices &columns);
+  /**Return the columns of a sparse matrix in the given order, which may
+     repeat columns.*/
+  const CSparse take_columns(const CSparse &s, const Indices &columns);
+  /**Return the matrix s(rows,columns), as in Matlab. Ranges of rows or
+     columns can be given with iota().*/
+  const RSparse submatrix(const RSparse &s, const Indices &rows, const Indices &columns);
+  /**Return the matrix s(rows,columns), as in Matlab. Ranges of rows or
+     columns can be given with iota().*/
+  const CSparse submatrix(const CSparse &s, const Indices &rows, const Indices &columns);
+
+  /**Reverse Cuthill-McKee ordering of a square sparse matrix, computed on
+     the pattern of s + transpose(s). The permutation p lists the old
+     indices in their new order: permute(s,p) has a smaller bandwidth, which
+     improves the locality of mmult().*/
+  const Indices reverse_cuthill_mckee(const RSparse &s);
+  /**Reverse Cuthill-McKee ordering of a square sparse matrix.*/
+  const Indices reverse_cuthill_mckee(const CSparse &s);
+  /**Return s(p,p), the square matrix with rows and columns reordered.*/
+  const RSparse permute(const RSparse &s, const Indices &p);
+  /**Return s(p,p), the square matrix with rows and columns reordered.*/
+  const CSparse permute(const CSparse &s, const Indices &p);
+  /**Largest distance between a nonzero element and the diagonal.*/
+  index bandwidth(const RSparse &s);
+  /**Largest distance between a nonzero element and the diagonal.*/
+  index bandwidth(const CSparse &s);
+  /**Return the tensor with its first index reordered, t(rows,...). This
+     applies a permutation from reverse_cuthill_mckee() to vectors.*/
+  const RTensor take_rows(const RTensor &t, const Indices &rows);
+  /**Return the tensor with its first index reordered, t(rows,...).*/
+  const CTensor take_rows(const CTensor &t, const Indices &rows);
+  /**Return the permutation q that undoes p, such that q[p[k]] = k.*/
+  const Indices inverse_permutation(const Indices &p);
+
+  /**Return the given diagonal of a sparse matrix as a vector.*/
+  const RTensor take_diag(const RSparse &s, int which = 0);
+  /**Return the given diagonal of a sparse matrix as a vector.*/
+  const CTensor take_diag(const CSparse &s, int which = 0);
+  /**Trace of a sparse matrix.*/
+  double trace(const RSparse &s);
+  /**Trace of a sparse matrix.*/
+  cdouble trace(const CSparse &s);
+  /**Return the sum of all elements in a sparse matrix.*/
+  double sum(const RSparse &s);
+  /**Return the sum of all elements in a sparse matrix.*/
+  cdouble sum(const CSparse &s);
+  /**Sum a sparse matrix along the given dimension: sum(s,0) is a vector
+     with the sums of each column and sum(s,1) has the sums of each row.*/
+  const RTensor sum(const RSparse &s, int which);
+  /**Sum a sparse matrix along the given dimension: sum(s,0) is a vector
+     with the sums of each column and sum(s,1) has the sums of each row.*/
+  const CTensor sum(const CSparse &s, int which);
+  /**Frobenius norm of a sparse matrix.*/
+  double norm2(const RSparse &s);
+  /**Frobenius norm of a sparse matrix.*/
+  double norm2(const CSparse &s);
+  /**Largest sum of the absolute values of the elements in a row.*/
+  double matrix_norminf(const RSparse &s);
+  /**Largest sum of the absolute values of the elements in a row.*/
+  double matrix_norminf(const CSparse &s);
+
+  /**Compute A += alpha * B, in place when the elements of B are a subset of
+     those of A. Elements that cancel are removed, as in A + alpha * B.*/
+  void axpy(RSparse &A, double alpha, const RSparse &B);
+  /**Compute A += alpha * B, in place when the elements of B are a subset of
+     those of A. Elements that cancel are removed, as in A + alpha * B.*/
+  void axpy(CSparse &A, cdouble alpha, const CSparse &B);
+
+  inline RSparse &operator+=(RSparse &A, const RSparse &B) {
+    axpy(A, 1.0, B);
+    return A;
+  }
+  inline CSparse &operator+=(CSparse &A, const CSparse &B) {
+    axpy(A, number_one<cdouble>(), B);
+    return A;
+  }
+
   /**Kronecker product between matrices, in Matlab order.*/
   const RSparse kron(const RSparse &s1, const RSparse &s2);
   /**Kronecker product between matrices, opposite to Matlab order.*/
@@ -147,6 +147,9 @@ class Tensor {
 
   /**Change the dimensions, while keeping the data. */
   void reshape(const Indices &new_dims);
+  /**Change the dimensions, reusing the data only if it is not shared and
+     has the right size. Otherwise the contents are undefined. */
+  void resize(const Indices &new_dims);
 
   /**Return the i-th element, accessed in column major order.*/
   const elt_t &operator[](index i) const;
@@ -395,6 +398,17 @@ namespace tensor {
   RTensor sqrt(const RTensor &t);
   RTensor log(const RTensor &t);
 
+  void abs_into(RTensor &output, const RTensor &t);
+  void cos_into(RTensor &output, const RTensor &t);
+  void sin_into(RTensor &output, const RTensor &t);
+  void tan_into(RTensor &output, const RTensor &t);
+  void cosh_into(RTensor &output, const RTensor &t);
+  void sinh_into(RTensor &output, const RTensor &t);
+  void tanh_into(RTensor &output, const RTensor &t);
+  void exp_into(RTensor &output, const RTensor &t);
+  void sqrt_into(RTensor &output, const RTensor &t);
+  void log_into(RTensor &output, const RTensor &t);
+
   RTensor round(const RTensor &t);
 
   const RTensor diag(const RTensor &d, int which, int rows, int cols);
@@ -419,6 +433,10 @@ namespace tensor {
   const RTensor transpose(const RTensor &a);
   inline const RTensor adjoint(const RTensor &a) { return transpose(a); }
 
+  void permute_into(RTensor &output, const RTensor &a, index ndx1 = 0, index ndx2 = -1);
+  void transpose_into(RTensor &output, const RTensor &a);
+  inline void adjoint_into(RTensor &output, const RTensor &a) { transpose_into(output, a); }
+
   const RTensor fold(const RTensor &a, int ndx1, const RTensor &b, int ndx2);
   const RTensor foldc(const RTensor &a, int ndx1, const RTensor &b, int ndx2);
   const RTensor foldin(const RTensor &a, int ndx1, const RTensor &b, int ndx2);
@@ -428,6 +446,15 @@ namespace tensor {
   void foldin_into(RTensor &output, const RTensor &a, int ndx1, const RTensor &b, int ndx2);
   void mmult_into(RTensor &output, const RTensor &a, const RTensor &b);
 
+  void fold_acc(RTensor &output, double alpha, const RTensor &a, int ndx1,
+                const RTensor &b, int ndx2, double beta = 1.0);
+  void foldc_acc(RTensor &output, double alpha, const RTensor &a, int ndx1,
+                 const RTensor &b, int ndx2, double beta = 1.0);
+  void foldin_acc(RTensor &output, double alpha, const RTensor &a, int ndx1,
+                  const RTensor &b, int ndx2, double beta = 1.0);
+  void mmult_acc(RTensor &output, double alpha, const RTensor &a,
+                 const RTensor &b, double beta = 1.0);
+
   bool all_equal(const RTensor &a, const RTensor &b);
   bool all_equal(const RTensor &a, double b);
   inline bool all_equal(double b, const RTensor &a) { return all_equal(a, b); }
@@ -473,10 +500,26 @@ namespace tensor {
   RTensor &operator+=(RTensor &a, const RTensor &b);
   RTensor &operator-=(RTensor &a, const RTensor &b);
 
+  void plus_into(RTensor &output, const RTensor &a, const RTensor &b);
+  void plus_into(RTensor &output, const RTensor &a, double b);
+  void plus_into(RTensor &output, double a, const RTensor &b);
+  void minus_into(RTensor &output, const RTensor &a, const RTensor &b);
+  void minus_into(RTensor &output, const RTensor &a, double b);
+  void minus_into(RTensor &output, double a, const RTensor &b);
+  void times_into(RTensor &output, const RTensor &a, const RTensor &b);
+  void times_into(RTensor &output, const RTensor &a, double b);
+  void times_into(RTensor &output, double a, const RTensor &b);
+  void divide_into(RTensor &output, const RTensor &a, const RTensor &b);
+  void divide_into(RTensor &output, const RTensor &a, double b);
+  void divide_into(RTensor &output, double a, const RTensor &b);
+
   const RTensor kron(const RTensor &a, const RTensor &b);
   const RTensor kron2(const RTensor &a, const RTensor &b);
   const RTensor kron2_sum(const RTensor &a, const RTensor &b);
 
+  void kron_into(RTensor &output, const RTensor &a, const RTensor &b);
+  void kron2_into(RTensor &output, const RTensor &a, const RTensor &b);
+
   extern template class Tensor<cdouble>;
   /** Complex Tensor with elements of type "cdouble". */
 #ifdef DOXYGEN_ONLY
@@ -523,6 +566,17 @@ namespace tensor {
   CTensor sqrt(const CTensor &t);
   CTensor log(const CTensor &t);
 
+  void abs_into(RTensor &output, const CTensor &t);
+  void cos_into(CTensor &output, const CTensor &t);
+  void sin_into(CTensor &output, const CTensor &t);
+  void tan_into(CTensor &output, const CTensor &t);
+  void cosh_into(CTensor &output, const CTensor &t);
+  void sinh_into(CTensor &output, const CTensor &t);
+  void tanh_into(CTensor &output, const CTensor &t);
+  void exp_into(CTensor &output, const CTensor &t);
+  void sqrt_into(CTensor &output, const CTensor &t);
+  void log_into(CTensor &output, const CTensor &t);
+
   const CTensor diag(const CTensor &d, int which, int rows, int cols);
   const CTensor diag(const CTensor &d, int which = 0);
   const CTensor take_diag(const CTensor &d, int which = 0, int ndx1 = 0, int ndx2 = -1);
@@ -545,6 +599,10 @@ namespace tensor {
   const CTensor transpose(const CTensor &a);
   const CTensor adjoint(const CTensor &a);
 
+  void permute_into(CTensor &output, const CTensor &a, index ndx1 = 0, index ndx2 = -1);
+  void transpose_into(CTensor &output, const CTensor &a);
+  void adjoint_into(CTensor &output, const CTensor &a);
+
   const CTensor fold(const CTensor &a, int ndx1, const CTensor &b, int ndx2);
   const CTensor fold(const RTensor &a, int ndx1, const CTensor &b, int ndx2);
   const CTensor fold(const CTensor &a, int ndx1, const RTensor &b, int ndx2);
@@ -557,12 +615,28 @@ namespace tensor {
   const CTensor mmult(const RTensor &a, const CTensor &b);
   const CTensor mmult(const CTensor &a, const RTensor &b);
 
+  void fold_into(CTensor &output, const CTensor &a, int ndx1, const CTensor &b, int ndx2);
+  void foldin_into(CTensor &output, const CTensor &a, int ndx1, const CTensor &b, int ndx2);
+  void mmult_into(CTensor &output, const CTensor &a, const CTensor &b);
+
+  void fold_acc(CTensor &output, cdouble alpha, const CTensor &a, int ndx1,
+                const CTensor &b, int ndx2, cdouble beta = number_one<cdouble>());
+  void foldc_acc(CTensor &output, cdouble alpha, const CTensor &a, int ndx1,
+                 const CTensor &b, int ndx2, cdouble beta = number_one<cdouble>());
+  void foldin_acc(CTensor &output, cdouble alpha, const CTensor &a, int ndx1,
+                  const CTensor &b, int ndx2, cdouble beta = number_one<cdouble>());
+  void mmult_acc(CTensor &output, cdouble alpha, const CTensor &a,
+                 const CTensor &b, cdouble beta = number_one<cdouble>());
+
   const RTensor scale(const RTensor &t, int ndx1, const RTensor &v);
   const CTensor scale(const CTensor &t, int ndx1, const CTensor &v);
   const CTensor scale(const CTensor &t, int ndx1, const RTensor &v);
   void scale_inplace(RTensor &t, int ndx1, const RTensor &v);
   void scale_inplace(CTensor &t, int ndx1, const CTensor &v);
   void scale_inplace(CTensor &t, int ndx1, const RTensor &v);
+  void scale_into(RTensor &output, const RTensor &t, int ndx1, const RTensor &v);
+  void scale_into(CTensor &output, const CTensor &t, int ndx1, const CTensor &v);
+  void scale_into(CTensor &output, const CTensor &t, int ndx1, const RTensor &v);
 
   const CTensor foldin(const CTensor &a, int ndx1, const CTensor &b, int ndx2);
 
@@ -609,10 +683,26 @@ namespace tensor {
   CTensor &operator+=(CTensor &a, const CTensor &b);
   CTensor &operator-=(CTensor &a, const CTensor &b);
 
+  void plus_into(CTensor &output, const CTensor &a, const CTensor &b);
+  void plus_into(CTensor &output, const CTensor &a, cdouble b);
+  void plus_into(CTensor &output, cdouble a, const CTensor &b);
+  void minus_into(CTensor &output, const CTensor &a, const CTensor &b);
+  void minus_into(CTensor &output, const CTensor &a, cdouble b);
+  void minus_into(CTensor &output, cdouble a, const CTensor &b);
+  void times_into(CTensor &output, const CTensor &a, const CTensor &b);
+  void times_into(CTensor &output, const CTensor &a, cdouble b);
+  void times_into(CTensor &output, cdouble a, const CTensor &b);
+  void divide_into(CTensor &output, const CTensor &a, const CTensor &b);
+  void divide_into(CTensor &output, const CTensor &a, cdouble b);
+  void divide_into(CTensor &output, cdouble a, const CTensor &b);
+
   const CTensor kron(const CTensor &a, const CTensor &b);
   const CTensor kron2(const CTensor &a, const CTensor &b);
   const CTensor kron2_sum(const CTensor &a, const CTensor &b);
 
+  void kron_into(CTensor &output, const CTensor &a, const CTensor &b);
+  void kron2_into(CTensor &output, const CTensor &a, const CTensor &b);
+
   /** Convert a vector of indices to a 1D tensor of real numbers.*/
   const RTensor index_to_tensor(const Indices &i);
 
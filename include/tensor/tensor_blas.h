@@ -134,6 +134,10 @@ namespace blas {
       return CblasTrans;
     if (op == 'C')
       return CblasConjTrans;
+#ifdef TENSOR_USE_OPENBLAS
+    if (op == 'R')
+      return CblasConjNoTrans;
+#endif
     return CblasNoTrans;
   }
 #endif
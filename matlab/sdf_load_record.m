@@ -15,6 +15,10 @@ switch code
  case 3
   obj = sdf_load_mp(f, 1);
   dims = [length(obj)];
+ case 4
+  [obj,dims] = sdf_load_sparse(f, 0);
+ case 5
+  [obj,dims] = sdf_load_sparse(f, 1);
  otherwise
   error(['Wrong tag, ' num2str(code) ', found while reading ' f{2}]);
 end
@@ -75,6 +79,27 @@ if rank > 1
 end;
 
 
+function [S,dims] = sdf_load_sparse(f, cplx)
+global SDF_ENDIAN;
+dims = read_longs(f{1}, read_longs(f{1}, 1))';
+row_start = read_longs(f{1}, read_longs(f{1}, 1));
+column = read_longs(f{1}, read_longs(f{1}, 1));
+L = read_longs(f{1}, 1);
+if cplx
+  data = fread(f{1}, L*2, 'double', 0, SDF_ENDIAN);
+  data = complex(data(1:2:end),data(2:2:end));
+else
+  data = fread(f{1}, L, 'double', 0, SDF_ENDIAN);
+end;
+% Rows of each element, from the offsets of the rows
+L = row_start(end);
+rows = zeros(L,1);
+nonempty = find(diff(row_start) > 0);
+rows(row_start(nonempty) + 1) = diff([0; nonempty]);
+rows = cumsum(rows);
+S = sparse(rows, column(1:L) + 1, data(1:L), dims(1), dims(2));
+
+
 function P = sdf_load_mp(f, cplx)
 global SDF_LOAD_MPS;
 L = read_longs(f{1}, 1);
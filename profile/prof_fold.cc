@@ -0,0 +1,86 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <tensor/tensor.h>
+#include "../src/tensor/gemm.cc"
+#include "profile.h"
+
+using namespace tensor;
+using namespace profile;
+
+//
+// Compare the unrolled kernels used for tiny contracted dimensions with
+// the plain BLAS calls that were used before.
+//
+template<typename elt_t>
+void prof_gemm(const char *name, tensor::index d, bool small, const int repeats=16*1024,
+               const int maxsize=0x1000)
+{
+  PROF_BEGIN_SET(name) {
+    for (tensor::index size = 2; size < maxsize; size <<= 2) {
+      Tensor<elt_t> A = Tensor<elt_t>::random(size, d);
+      Tensor<elt_t> B = Tensor<elt_t>::random(d, d);
+      Tensor<elt_t> C(size, d);
+      const elt_t *pA = A.begin(), *pB = B.begin();
+      elt_t *pC = C.begin();
+      elt_t one = number_one<elt_t>(), zero = number_zero<elt_t>();
+      if (small) {
+        PROF_ENTRY(size, blas::small_gemm('N', 'N', size, d, d, one, pA, size,
+                                          pB, d, zero, pC, size), repeats);
+      } else {
+        PROF_ENTRY(size, blas::gemm('N', 'N', size, d, d, one, pA, size,
+                                    pB, d, zero, pC, size), repeats);
+      }
+    }
+  } PROF_END_SET;
+}
+
+template<typename elt_t>
+void prof_fold(const char *name, tensor::index d, const int repeats=16*1024,
+               const int maxsize=0x1000)
+{
+  PROF_BEGIN_SET(name) {
+    for (tensor::index size = 2; size < maxsize; size <<= 2) {
+      Tensor<elt_t> A = Tensor<elt_t>::random(size, d, size);
+      Tensor<elt_t> B = Tensor<elt_t>::random(d, d);
+      PROF_ENTRY(size, fold(A, 1, B, 0), (repeats/size));
+    }
+  } PROF_END_SET;
+}
+
+int main()
+{
+  PROF_BEGIN_GROUP("RTensor") {
+    prof_gemm<double>("gemm2", 2, false);
+    prof_gemm<double>("small_gemm2", 2, true);
+    prof_gemm<double>("gemm4", 4, false);
+    prof_gemm<double>("small_gemm4", 4, true);
+    prof_fold<double>("fold2", 2);
+    prof_fold<double>("fold4", 4);
+  } PROF_END_GROUP;
+
+  PROF_BEGIN_GROUP("CTensor") {
+    prof_gemm<cdouble>("gemm2", 2, false);
+    prof_gemm<cdouble>("small_gemm2", 2, true);
+    prof_gemm<cdouble>("gemm4", 4, false);
+    prof_gemm<cdouble>("small_gemm4", 4, true);
+    prof_fold<cdouble>("fold2", 2);
+    prof_fold<cdouble>("fold4", 4);
+  } PROF_END_GROUP;
+}
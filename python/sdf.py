@@ -83,6 +83,10 @@ class SDF:
             obj = self.load_mp(False)
         elif code == 3:
             obj = self.load_mp(True)
+        elif code == 4:
+            obj = self.load_sparse(False)
+        elif code == 5:
+            obj = self.load_sparse(True)
         else:
             raise Error('Unknown SDF tag')
         return obj, name
@@ -102,6 +106,20 @@ class SDF:
             data = self.read_doubles(L)
         return np.ndarray(shape=dims,buffer=data,dtype=data.dtype,order='F')
 
+    def load_sparse(self, iscomplex):
+        import scipy.sparse
+        dims = self.read_longs(self.read_longs(1)[0])
+        row_start = self.read_longs(self.read_longs(1)[0])
+        column = self.read_longs(self.read_longs(1)[0])
+        L = self.read_longs(1)[0]
+        if iscomplex:
+            data = self.read_complex(L)
+        else:
+            data = self.read_doubles(L)
+        nonzero = row_start[-1]
+        return scipy.sparse.csr_matrix((data[:nonzero], column[:nonzero], row_start),
+                                       shape=tuple(dims))
+
     def read_longs(self, n):
         output = np.ndarray(shape=(n,),dtype=self.long_type)
         self.f.readinto(output)
@@ -21,23 +21,35 @@
 
 namespace tensor {
 
-  const Tensor<double> operator-(const Tensor<double> &a, double b) {
-    Tensor<double> output(a.dimensions());
+  void minus_into(Tensor<double> &output, const Tensor<double> &a, double b) {
+    if ((void*)&output != (void*)&a)
+      output.resize(a.dimensions());
     Tensor<double>::const_iterator ita = a.begin();
     Tensor<double>::iterator dest = output.begin();
     for (index i = a.size(); i; --i, ++dest, ++ita) {
       *dest = (*ita) - (b);
     }
-    return output;
   }
 
-  const Tensor<double> operator-(double a, const Tensor<double> &b) {
-    Tensor<double> output(b.dimensions());
+  void minus_into(Tensor<double> &output, double a, const Tensor<double> &b) {
+    if ((void*)&output != (void*)&b)
+      output.resize(b.dimensions());
     Tensor<double>::const_iterator itb = b.begin();
     Tensor<double>::iterator dest = output.begin();
     for (index i = b.size(); i; --i, ++dest, ++itb) {
       *dest = (a) - (*itb);
     }
+  }
+
+  const Tensor<double> operator-(const Tensor<double> &a, double b) {
+    Tensor<double> output;
+    minus_into(output, a, b);
+    return output;
+  }
+
+  const Tensor<double> operator-(double a, const Tensor<double> &b) {
+    Tensor<double> output;
+    minus_into(output, a, b);
     return output;
   }
 
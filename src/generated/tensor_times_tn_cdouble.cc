@@ -21,23 +21,35 @@
 
 namespace tensor {
 
-  const Tensor<cdouble> operator*(const Tensor<cdouble> &a, cdouble b) {
-    Tensor<cdouble> output(a.dimensions());
+  void times_into(Tensor<cdouble> &output, const Tensor<cdouble> &a, cdouble b) {
+    if ((void*)&output != (void*)&a)
+      output.resize(a.dimensions());
     Tensor<cdouble>::const_iterator ita = a.begin();
     Tensor<cdouble>::iterator dest = output.begin();
     for (index i = a.size(); i; --i, ++dest, ++ita) {
       *dest = (*ita) * (b);
     }
-    return output;
   }
 
-  const Tensor<cdouble> operator*(cdouble a, const Tensor<cdouble> &b) {
-    Tensor<cdouble> output(b.dimensions());
+  void times_into(Tensor<cdouble> &output, cdouble a, const Tensor<cdouble> &b) {
+    if ((void*)&output != (void*)&b)
+      output.resize(b.dimensions());
     Tensor<cdouble>::const_iterator itb = b.begin();
     Tensor<cdouble>::iterator dest = output.begin();
     for (index i = b.size(); i; --i, ++dest, ++itb) {
       *dest = (a) * (*itb);
     }
+  }
+
+  const Tensor<cdouble> operator*(const Tensor<cdouble> &a, cdouble b) {
+    Tensor<cdouble> output;
+    times_into(output, a, b);
+    return output;
+  }
+
+  const Tensor<cdouble> operator*(cdouble a, const Tensor<cdouble> &b) {
+    Tensor<cdouble> output;
+    times_into(output, a, b);
     return output;
   }
 
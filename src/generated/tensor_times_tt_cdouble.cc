@@ -21,15 +21,23 @@
 
 namespace tensor {
 
-  const Tensor<cdouble> operator*(const Tensor<cdouble> &a, const Tensor<cdouble> &b) {
+  void times_into(Tensor<cdouble> &output, const Tensor<cdouble> &a, const Tensor<cdouble> &b) {
     assert(a.size() == b.size());
-    Tensor<cdouble> output(a.dimensions());
+    if ((void*)&output == (void*)&b)
+      output.reshape(a.dimensions());
+    else if ((void*)&output != (void*)&a)
+      output.resize(a.dimensions());
     Tensor<cdouble>::const_iterator ita = a.begin();
     Tensor<cdouble>::const_iterator itb = b.begin();
     Tensor<cdouble>::iterator dest = output.begin();
     for (index i = a.size(); i; --i, ++dest, ++ita, ++itb) {
       *dest = (*ita) * (*itb);
     }
+  }
+
+  const Tensor<cdouble> operator*(const Tensor<cdouble> &a, const Tensor<cdouble> &b) {
+    Tensor<cdouble> output;
+    times_into(output, a, b);
     return output;
   }
 
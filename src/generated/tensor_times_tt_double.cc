@@ -21,15 +21,23 @@
 
 namespace tensor {
 
-  const Tensor<double> operator*(const Tensor<double> &a, const Tensor<double> &b) {
+  void times_into(Tensor<double> &output, const Tensor<double> &a, const Tensor<double> &b) {
     assert(a.size() == b.size());
-    Tensor<double> output(a.dimensions());
+    if ((void*)&output == (void*)&b)
+      output.reshape(a.dimensions());
+    else if ((void*)&output != (void*)&a)
+      output.resize(a.dimensions());
     Tensor<double>::const_iterator ita = a.begin();
     Tensor<double>::const_iterator itb = b.begin();
     Tensor<double>::iterator dest = output.begin();
     for (index i = a.size(); i; --i, ++dest, ++ita, ++itb) {
       *dest = (*ita) * (*itb);
     }
+  }
+
+  const Tensor<double> operator*(const Tensor<double> &a, const Tensor<double> &b) {
+    Tensor<double> output;
+    times_into(output, a, b);
     return output;
   }
 
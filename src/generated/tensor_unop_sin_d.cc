@@ -22,13 +22,20 @@
 
 namespace tensor {
 
-  Tensor<double> sin(const Tensor<double> &t) {
-    Tensor<double> output(t.dimensions());
-    Tensor<double>::const_iterator src = t.begin();
+  void sin_into(Tensor<double> &output, const Tensor<double> &t) {
+    if ((void*)&output != (void*)&t)
+      output.resize(t.dimensions());
+    // 'dest' first: it unshares the buffer when 'output' aliases 't'
     Tensor<double>::iterator dest = output.begin();
-    for (; src != t.end(); src++, dest++) {
+    Tensor<double>::const_iterator src = t.begin();
+    for (index i = t.size(); i; --i, ++src, ++dest) {
       *dest = std::sin(*src);
     }
+  }
+
+  Tensor<double> sin(const Tensor<double> &t) {
+    Tensor<double> output;
+    sin_into(output, t);
     return output;
   }
 
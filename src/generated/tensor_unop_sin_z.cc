@@ -22,13 +22,20 @@
 
 namespace tensor {
 
-  Tensor<cdouble> sin(const Tensor<cdouble> &t) {
-    Tensor<cdouble> output(t.dimensions());
-    Tensor<cdouble>::const_iterator src = t.begin();
+  void sin_into(Tensor<cdouble> &output, const Tensor<cdouble> &t) {
+    if ((void*)&output != (void*)&t)
+      output.resize(t.dimensions());
+    // 'dest' first: it unshares the buffer when 'output' aliases 't'
     Tensor<cdouble>::iterator dest = output.begin();
-    for (; src != t.end(); src++, dest++) {
+    Tensor<cdouble>::const_iterator src = t.begin();
+    for (index i = t.size(); i; --i, ++src, ++dest) {
       *dest = std::sin(*src);
     }
+  }
+
+  Tensor<cdouble> sin(const Tensor<cdouble> &t) {
+    Tensor<cdouble> output;
+    sin_into(output, t);
     return output;
   }
 
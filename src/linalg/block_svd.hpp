@@ -36,20 +36,11 @@ namespace linalg {
       return svd(A, pU, pVT, economic);
     index minrc = std::min(rows, cols);
 
-    index nblocks;
-    Indices *block_rows, *block_cols;
-    if (!find_blocks<Tensor>(A, &nblocks, &block_rows, &block_cols)) {
+    std::vector<Indices> block_rows, block_cols;
+    if (!find_blocks(A, &block_rows, &block_cols)) {
       return svd(A, pU, pVT, economic);
     }
-
-    if ((nblocks == 1) &&
-	(block_rows[0].size() >= rows/2) &&
-	(block_cols[0].size() >= cols/2)) {
-      RTensor s = svd(A, pU, pVT, economic);
-      delete[] block_rows;
-      delete[] block_cols;
-      return s;
-    }
+    index nblocks = block_rows.size();
 
     RTensor s(minrc);
     s.fill_with_zeros();
@@ -60,41 +51,62 @@ namespace linalg {
       *pVT = Tensor::zeros(economic? minrc : cols, cols);
     }
 
-    RTensor stemp;
-    Tensor Utemp, Vtemp;
-    Tensor *pUtemp = pU? &Utemp : 0;
-    Tensor *pVtemp = pVT? &Vtemp : 0;
+    /* The singular values of block 'b' fill a contiguous segment of 's'
+       starting at offset[b], and so do the columns of U and rows of VT. */
+    Indices offset(nblocks);
+    RTensor weight(nblocks);
     for (index b = 0, sndx = 0; b < nblocks; b++) {
-      Tensor m = A(range(block_rows[b]), range(block_cols[b]));
-      index n = m.size();
-      if (m.size() > 1) {
-	stemp = svd(m, pUtemp, pVtemp, economic);
-        index slast = sndx + stemp.size() - 1;
-	s.at(range(sndx, slast)) = stemp;
-	if (pU) {
-          (*pU).at(range(block_rows[b]), range(sndx, slast)) = Utemp;
-	}
-	if (pVT) {
-          (*pVT).at(range(sndx, slast), range(block_cols[b])) = Vtemp;
-	}
-        sndx = slast + 1;
-      } else {
-	index row = block_rows[b][0];
-	index col = block_cols[b][0];
-	double aux = abs(m[0]);
-	s.at(sndx) = aux;
-	if (pU) {
-	  (*pU).at(row,sndx) = 1.0;
-	}
-	if (pVT) {
-	  (*pVT).at(sndx,col) = m[0]/aux;
-	}
-	++sndx;
-      }
+      index nr = block_rows[b].size(), nc = block_cols[b].size();
+      offset.at(b) = sndx;
+      sndx += std::min(nr, nc);
+      weight.at(b) = (double)nr * (double)nc;
     }
-    delete[] block_rows;
-    delete[] block_cols;
+    /* Largest blocks are decomposed first, for load balance. */
+    Indices order = sort_indices(weight, true);
 
+    typedef typename Tensor::elt_t elt_t;
+    const elt_t *pA = A.begin();
+    double *ps = s.begin();
+    elt_t *pu = pU? pU->begin() : 0;
+    elt_t *pv = pVT? pVT->begin() : 0;
+    index urows = rows, vrows = pVT? pVT->rows() : 0;
+#pragma omp parallel for schedule(dynamic) if (nblocks > 1)
+    for (index k = 0; k < nblocks; k++) {
+      index b = order[k];
+      const Indices &brows = block_rows[b];
+      const Indices &bcols = block_cols[b];
+      index nr = brows.size(), nc = bcols.size(), sndx = offset[b];
+      if (nr == 1 && nc == 1) {
+        elt_t x = pA[brows[0] + bcols[0] * rows];
+        double aux = abs(x);
+        ps[sndx] = aux;
+        if (pu) pu[brows[0] + sndx * urows] = number_one<elt_t>();
+        if (pv) pv[sndx + bcols[0] * vrows] = x / aux;
+        continue;
+      }
+      Tensor m(nr, nc);
+      for (index j = 0; j < nc; j++) {
+        const elt_t *column = pA + bcols[j] * rows;
+        for (index i = 0; i < nr; i++)
+          m.at(i, j) = column[brows[i]];
+      }
+      Tensor Utemp, Vtemp;
+      RTensor stemp = svd(m, pu? &Utemp : 0, pv? &Vtemp : 0, true);
+      index ns = stemp.size();
+      std::copy(stemp.begin(), stemp.end(), ps + sndx);
+      if (pu) {
+        const elt_t *u = Utemp.begin_const();
+        for (index j = 0; j < ns; j++)
+          for (index i = 0; i < nr; i++)
+            pu[brows[i] + (sndx + j) * urows] = u[i + j * nr];
+      }
+      if (pv) {
+        const elt_t *v = Vtemp.begin_const();
+        for (index j = 0; j < nc; j++)
+          for (index i = 0; i < ns; i++)
+            pv[sndx + i + bcols[j] * vrows] = v[i + j * ns];
+      }
+    }
     Indices ndx = sort_indices(s, true);
     s = s(range(ndx));
     if (pU)
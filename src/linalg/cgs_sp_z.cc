@@ -21,7 +21,7 @@
 
 namespace linalg {
 
-  /**Solve a real linear system of equations by the conjugate gradient method.
+  /**Solve a complex linear system of equations by the conjugate gradient method.
 
      Given a matrix A, and a right hand matrix B, we find the matrix X that
      satisfies
@@ -36,4 +36,17 @@ namespace linalg {
     return do_cgs(new tensor::MatrixMap<CSparse>(A), b, x_start, maxiter, tol);
   }
 
+  /**Solve a linear system of equations with a real sparse matrix and a
+     complex right hand side by the conjugate gradient method. The matrix is
+     applied to complex vectors without converting it.
+     \ingroup Linalg
+  */
+  const CTensor
+  cgs(const RSparse &A, const CTensor &b, const CTensor *x_start,
+      int maxiter, double tol)
+  {
+    return do_cgs(new tensor::MatrixMap<RSparse,CTensor>(A), b, x_start,
+                  maxiter, tol);
+  }
+
 }
@@ -42,6 +42,20 @@ namespace linalg {
   */
   RTensor
   eig_sym(const RTensor &A, RTensor *V)
+  {
+    RTensor output;
+    eig_sym_into(output, A, V);
+    return output;
+  }
+
+  /**Similar to eig_sym(), but the eigenvalues are written into \c output.
+     The storage of \c output and \c V is reused when it has the right size
+     and is not shared.
+
+     \ingroup Linalg
+  */
+  void
+  eig_sym_into(RTensor &output, const RTensor &A, RTensor *V)
   {
     assert(A.rows() > 0);
     assert(A.rank() == 2);
@@ -54,12 +68,21 @@ namespace linalg {
       abort();
     }
 
-    RTensor aux(A);
-    double *a = tensor_pointer(aux);
+    // LAPACK overwrites the matrix with the eigenvectors. When these are
+    // requested, we copy A into V and work there.
+    RTensor aux;
+    if (V && V != &A) {
+      V->resize(A.dimensions());
+      std::copy(A.begin(), A.end(), V->begin());
+    } else {
+      aux = A;
+    }
+    RTensor &M = (V && V != &A)? *V : aux;
+    double *a = tensor_pointer(M);
     blas::integer lda = n, info[1];
     char jobz[2] = { (V == 0)? 'N' : 'V', 0 };
     char uplo[2] = { 'U', 0 };
-    RTensor output(n);
+    output.resize(tensor::igen << n);
     double *w = tensor_pointer(output);
 
 #ifdef TENSOR_USE_ACML
@@ -75,8 +98,7 @@ namespace linalg {
                    &lwork, info);
 #endif
 
-    if (V) *V = aux;
-    return output;
+    if (V && &M != V) *V = aux;
   }
 
 } // namespace linalg
@@ -42,6 +42,20 @@ namespace linalg {
   */
   RTensor
   eig_sym(const CTensor &A, CTensor *V)
+  {
+    RTensor output;
+    eig_sym_into(output, A, V);
+    return output;
+  }
+
+  /**Similar to eig_sym(), but the eigenvalues are written into \c output.
+     The storage of \c output and \c V is reused when it has the right size
+     and is not shared.
+
+     \ingroup Linalg
+  */
+  void
+  eig_sym_into(RTensor &output, const CTensor &A, CTensor *V)
   {
     assert(A.rows() > 0);
     assert(A.rank() == 2);
@@ -56,12 +70,21 @@ namespace linalg {
       abort();
     }
 
-    CTensor aux(A);
-    cdouble *a = tensor_pointer(aux);
+    // LAPACK overwrites the matrix with the eigenvectors. When these are
+    // requested, we copy A into V and work there.
+    CTensor aux;
+    if (V && V != &A) {
+      V->resize(A.dimensions());
+      std::copy(A.begin(), A.end(), V->begin());
+    } else {
+      aux = A;
+    }
+    CTensor &M = (V && V != &A)? *V : aux;
+    cdouble *a = tensor_pointer(M);
     blas::integer lda = n, info[1];
     char jobz[2] = { (V == 0)? 'N' : 'V', 0 };
     char uplo[2] = { 'U', 0 };
-    RTensor output(n);
+    output.resize(tensor::igen << n);
     double *w = tensor_pointer(output);
     RTensor rwork(3*n);
 
@@ -79,8 +102,7 @@ namespace linalg {
                    &lwork, tensor_pointer(rwork), info);
 #endif
 
-    if (V) *V = aux;
-    return output;
+    if (V && &M != V) *V = aux;
   }
 
 } // namespace linalg
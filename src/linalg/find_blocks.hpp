@@ -17,22 +17,106 @@
     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 */
 
-#include <list>
+#include <vector>
 #include <algorithm>
 #include <tensor/flags.h>
 #include <tensor/tensor.h>
+#include <tensor/sparse.h>
 
 namespace linalg {
 
   using namespace tensor;
   using tensor::index;
 
-  static void
-  replace_integer(index N, index v[], index old_value, index new_value)
+  /* Disjoint sets of integers, with union by size and path halving, so that
+     a sequence of operations runs in almost linear time. */
+  class BlockSets {
+  public:
+    explicit BlockSets(index n) : parent_(n), size_(n, 1) {
+      for (index i = 0; i < n; i++) parent_[i] = i;
+    }
+    index find(index i) {
+      while (parent_[i] != i) {
+        i = parent_[i] = parent_[parent_[i]];
+      }
+      return i;
+    }
+    void join(index i, index j) {
+      i = find(i);
+      j = find(j);
+      if (i != j) {
+        if (size_[i] < size_[j]) std::swap(i, j);
+        parent_[j] = i;
+        size_[i] += size_[j];
+      }
+    }
+  private:
+    std::vector<index> parent_, size_;
+  };
+
+  template<typename elt_t>
+  static inline bool
+  block_significant(const elt_t &x, double tol)
   {
-    for (index k = 0; k < N; k++) {
-      if (v[k] == old_value) v[k] = new_value;
+    return abs(real(x)) + abs(imag(x)) > tol;
+  }
+
+  /* Rows and columns are the nodes 0..N-1 and N..N+M-1 of 'sets'. Blocks
+     are numbered by their first column; only rows and columns with some
+     significant element belong to a block. */
+  static bool
+  collect_blocks(BlockSets &sets, index N, index M,
+                 const std::vector<char> &row_used,
+                 const std::vector<char> &col_used,
+                 std::vector<Indices> *block_rows,
+                 std::vector<Indices> *block_cols)
+  {
+    std::vector<index> block(N + M, -1), nrows, ncols;
+    for (index col = 0; col < M; col++) {
+      if (col_used[col]) {
+        index &b = block[sets.find(N + col)];
+        if (b < 0) {
+          b = ncols.size();
+          ncols.push_back(0);
+          nrows.push_back(0);
+        }
+        ncols[b]++;
+      }
+    }
+    for (index row = 0; row < N; row++) {
+      if (row_used[row])
+        nrows[block[sets.find(row)]]++;
+    }
+    index nblocks = ncols.size();
+    if (tensor::FLAGS.get(tensor::TENSOR_DEBUG_BLOCK_SVD)) {
+      std::cout << "*** find_blocks: nxm=" << N << "x" << M
+                << ", n_blocks=" << nblocks << std::endl;
+    }
+    block_rows->clear();
+    block_cols->clear();
+    if (nblocks == 1)
+      return false;
+
+    block_rows->resize(nblocks);
+    block_cols->resize(nblocks);
+    for (index b = 0; b < nblocks; b++) {
+      (*block_rows)[b] = Indices(nrows[b]);
+      (*block_cols)[b] = Indices(ncols[b]);
+      nrows[b] = ncols[b] = 0;
+    }
+    for (index col = 0; col < M; col++) {
+      if (col_used[col]) {
+        index b = block[sets.find(N + col)];
+        (*block_cols)[b].at(ncols[b]++) = col;
+      }
+    }
+    for (index row = 0; row < N; row++) {
+      if (row_used[row]) {
+        index b = block[sets.find(row)];
+        (*block_rows)[b].at(nrows[b]++) = row;
+      }
     }
+    return true;
   }
 
   /*Find blocks in a block-diagonal matrix.*/
@@ -55,106 +139,54 @@ namespace linalg {
     which shows the evident block-diagonal structure. The routine find_block()
     takes as input a matrix such as A and produces a two lists of vectors, each
     one denoting the rows and columns of the nonzero blocks in the matrix.
+    It returns false when the matrix forms a single block.
+
+    Every significant element A(i,j) joins the sets of row i and column j,
+    so that the cost is almost linear in the size of the matrix.
   */
   template<class Tensor>
   bool
-  find_blocks(const Tensor &A, index *pnblocks, Indices **pblock_rows, Indices **pblock_cols,
-	      double tol = 0.0)
+  find_blocks(const Tensor &A, std::vector<Indices> *block_rows,
+              std::vector<Indices> *block_cols, double tol = 0.0)
   {
     index N = A.rows();
     index M = A.columns();
-    if (N > M)
-      return find_blocks(transpose(A), pnblocks, pblock_cols, pblock_rows);
-
-    index &nblocks = *pnblocks;
-    Indices *&block_rows = *pblock_rows;
-    Indices *&block_cols = *pblock_cols;
-
-    index *row_block = new index[N];
-    index *col_block = new index[M];
-    const index aux = 0;
-    const index empty = ~aux;
-
-    for (index row = 0; row < N; row++)
-      row_block[row] = empty;
-
-    nblocks = 0;
+    BlockSets sets(N + M);
+    std::vector<char> row_used(N, 0), col_used(M, 0);
     const typename Tensor::elt_t *data = A.begin_const();
-
     for (index col = 0; col < M; col++) {
-      // For each col, we see what rowumns it is linked to. If some of these
-      // rowumns belongs to a block, and the current block is not set, we
-      // set our current block. Otherwise, we mix different blocks.
-      index curr_block = col;
-      bool set = 0;
       for (index row = 0; row < N; row++, data++) {
-	bool significant = abs(real(*data)) + abs(imag(*data)) > tol;
-	if (significant) {
-	  set = 1;
-	  index new_block = row_block[row];
-	  if (new_block == empty) {
-	    row_block[row] = curr_block;
-	  } else if (new_block != curr_block) {
-	    nblocks--;
-	    replace_integer(N, row_block, curr_block, new_block);
-	    replace_integer(col, col_block, curr_block, new_block);
-	    curr_block = new_block;
-	  }
-	}
-      }
-      if (set) {
-	nblocks++;
-	col_block[col] = curr_block;
-      } else {
-	col_block[col] = empty;
+        if (block_significant(*data, tol)) {
+          row_used[row] = col_used[col] = 1;
+          sets.join(row, N + col);
+        }
       }
     }
-    if (tensor::FLAGS.get(tensor::TENSOR_DEBUG_BLOCK_SVD)) {
-      std::cout << "*** find_blocks: nxm=" << N << "x" << M
-                << ", n_blocks=" << nblocks << std::endl;
-    }
-    if (nblocks == 1) {
-      block_rows = 0;
-      block_cols = 0;
-      delete[] row_block;
-      delete[] col_block;
-      return false;
-    }
-
-    index *buffer = new index[std::max<index>(N,M)];
-    block_cols = new Indices[nblocks];
-    block_rows = new Indices[nblocks];
-
-    for (index b = 0, col = 0; col < M; col++) {
-      index block = col_block[col];
-      if (block != empty) {
-	index block_ncols = 0;
-	for (index c = 0; c < M; c++) {
-	  if (col_block[c] == block) {
-	    buffer[block_ncols++] = c;
-	    col_block[c] = empty;
-	  }
-	}
-	assert(block_ncols);
-	block_cols[b] = Indices(block_ncols);
-	memcpy(block_cols[b].begin(), buffer, sizeof(index)*block_ncols);
+    return collect_blocks(sets, N, M, row_used, col_used, block_rows, block_cols);
+  }
 
-	index block_nrows = 0;
-	for (index r = 0; r < N; r++){
-	  if (row_block[r] == block) {
-	    buffer[block_nrows++] = r;
-	  }
-	}
-	assert(block_nrows);
-	block_rows[b] = Indices(block_nrows);
-	memcpy(block_rows[b].begin(), buffer, sizeof(index)*block_nrows);
-	b++;
+  /*Find blocks in a sparse matrix, reading only its nonzero elements.*/
+  template<typename elt_t>
+  bool
+  find_blocks(const Sparse<elt_t> &A, std::vector<Indices> *block_rows,
+              std::vector<Indices> *block_cols, double tol = 0.0)
+  {
+    index N = A.rows();
+    index M = A.columns();
+    BlockSets sets(N + M);
+    std::vector<char> row_used(N, 0), col_used(M, 0);
+    const index *row_start = A.priv_row_start().begin();
+    const index *column = A.priv_column().begin();
+    const elt_t *data = A.priv_data().begin();
+    for (index row = 0; row < N; row++) {
+      for (index x = row_start[row]; x < row_start[row+1]; x++) {
+        if (block_significant(data[x], tol)) {
+          row_used[row] = col_used[column[x]] = 1;
+          sets.join(row, N + column[x]);
+        }
       }
     }
-    delete[] buffer;
-    delete[] row_block;
-    delete[] col_block;
-    return true;
+    return collect_blocks(sets, N, M, row_used, col_used, block_rows, block_cols);
   }
 
 } // namespace linalg
@@ -48,6 +48,20 @@ namespace linalg {
   */
   RTensor
   svd(RTensor A, RTensor *U, RTensor *VT, bool economic)
+  {
+    RTensor output;
+    svd_into(output, A, U, VT, economic);
+    return output;
+  }
+
+  /**Similar to svd(), but the singular values are written into \c output,
+     and the storage of \c output, \c U and \c VT is reused when it has the
+     right size and is not shared.
+
+     \ingroup Linalg
+  */
+  void
+  svd_into(RTensor &output, RTensor A, RTensor *U, RTensor *VT, bool economic)
   {
     /*
       if (accurate_svd) {
@@ -63,13 +77,13 @@ namespace linalg {
     blas::integer n = A.columns();
     blas::integer k = std::min(m, n);
     blas::integer lwork, ldu, lda, ldv, info;
-    RTensor output(k);
+    output.resize(tensor::igen << k);
     double *work, *u, *v;
     double *a = tensor_pointer(A), *s = tensor_pointer(output), foo;
     char jobv[1], jobu[1];
 
     if (U) {
-      *U = RTensor(m, economic? k : m);
+      U->resize(tensor::igen << m << (economic? k : m));
       u = tensor_pointer(*U);
       jobu[0] = economic? 'S' : 'A';
       ldu = m;
@@ -79,7 +93,7 @@ namespace linalg {
       ldu = 1;
     }
     if (VT) {
-      (*VT) = RTensor(economic? k : n, n);
+      VT->resize(tensor::igen << (economic? k : n) << n);
       v = tensor_pointer(*VT);
       jobv[0] = economic? 'S' : 'A';
       ldv = economic? k : n;
@@ -102,7 +116,6 @@ namespace linalg {
 		    work, &lwork, &info);
     delete[] work;
 #endif
-    return output;
   }
 
 } // namespace linalg
@@ -43,6 +43,20 @@ namespace linalg {
   */
   RTensor
   svd(CTensor A, CTensor *U, CTensor *VT, bool economic)
+  {
+    RTensor output;
+    svd_into(output, A, U, VT, economic);
+    return output;
+  }
+
+  /**Similar to svd(), but the singular values are written into \c output,
+     and the storage of \c output, \c U and \c VT is reused when it has the
+     right size and is not shared.
+
+     \ingroup Linalg
+  */
+  void
+  svd_into(RTensor &output, CTensor A, CTensor *U, CTensor *VT, bool economic)
   {
     /*
     if (accurate_svd) {
@@ -57,13 +71,13 @@ namespace linalg {
     blas::integer n = A.columns();
     blas::integer k = std::min(m, n);
     blas::integer lwork, ldu, lda, ldv, info;
-    RTensor output(k);
+    output.resize(tensor::igen << k);
     cdouble *work, *u, *v, *a = tensor_pointer(A), foo;
     double *rwork, *s = tensor_pointer(output);
     char jobv[1], jobu[1];
     
     if (U) {
-      *U = CTensor(m, economic? k : m);
+      U->resize(tensor::igen << m << (economic? k : m));
       u = tensor_pointer(*U);
       jobu[0] = economic? 'S' : 'A';
       ldu = m;
@@ -73,7 +87,7 @@ namespace linalg {
       ldu = 1;
     }
     if (VT) {
-      (*VT) = CTensor(economic? k : n, n);
+      VT->resize(tensor::igen << (economic? k : n) << n);
       v = tensor_pointer(*VT);
       jobv[0] = economic? 'S' : 'A';
       ldv = economic? k : n;
@@ -99,7 +113,6 @@ namespace linalg {
     delete[] work;
     delete[] rwork;
 #endif
-    return output;
   }
 
 
@@ -130,11 +130,13 @@ const char *
 DataFile::tag_to_name(size_t tag)
 {
     static const char *names[] = {
-	"RTensor", "CTensor", "Real MPS", "Complex MPS"
+	"RTensor", "CTensor", "Real MPS", "Complex MPS",
+	"RSparse", "CSparse"
     };
 
-    if (tag > 4 /* || tag < 0 */) {
+    if (tag > 5 /* || tag < 0 */) {
 	std::cerr << "Not a valid tag code, " << tag << " found in " << _filename;
+	abort();
     }
     return names[tag];
 }
@@ -218,6 +218,49 @@ InDataFile::load(std::vector<CTensor> *m, const std::string &name)
   }
 }
 
+template<class Sparse>
+const Sparse InDataFile::load_sparse()
+{
+  Indices dims = load_vector<Indices>();
+  Indices row_start = load_vector<Indices>();
+  Indices column = load_vector<Indices>();
+  typename Sparse::tensor data = load_vector<typename Sparse::tensor>();
+  bool ok = dims.size() == 2 && dims[0] >= 0 && dims[1] >= 0 &&
+    row_start.size() == dims[0] + 1 && row_start[0] == 0 &&
+    row_start[dims[0]] == column.size() && column.size() == data.size();
+  // Rows are consecutive and their columns are increasing and in range
+  for (tensor::index r = 0; ok && r < dims[0]; r++) {
+    ok = row_start[r] <= row_start[r+1];
+  }
+  for (tensor::index r = 0; ok && r < dims[0]; r++) {
+    tensor::index first = row_start[r], last = row_start[r+1];
+    for (tensor::index j = first; ok && j < last; j++) {
+      ok = column[j] >= 0 && column[j] < dims[1] &&
+        (j == first || column[j-1] < column[j]);
+    }
+  }
+  if (!ok) {
+    std::cerr << "While reading file " << _filename
+              << ", found a corrupt sparse matrix." << std::endl;
+    abort();
+  }
+  return Sparse(dims, row_start, column, data);
+}
+
+void
+InDataFile::load(RSparse *s, const std::string &name)
+{
+  read_tag(name, TAG_RSPARSE);
+  *s = load_sparse<RSparse>();
+}
+
+void
+InDataFile::load(CSparse *s, const std::string &name)
+{
+  read_tag(name, TAG_CSPARSE);
+  *s = load_sparse<CSparse>();
+}
+
 void
 InDataFile::load(double *value, const std::string &name)
 {
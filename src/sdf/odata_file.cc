@@ -224,6 +224,35 @@ OutDataFile::dump(const std::vector<CTensor> &m, const std::string &name)
   }
 }
 
+/* Sparse matrices are stored in CSR form: dimensions, row offsets, column
+   indices and values, each one as a vector. */
+template<class Sparse>
+void OutDataFile::dump_sparse(const Sparse &s)
+{
+  // Only the first 'nonzero' elements of column_ and data_ are in use
+  tensor::index nonzero = s.priv_row_start()[s.rows()];
+  dump_vector(s.priv_dims());
+  dump_vector(s.priv_row_start());
+  write_raw(nonzero);
+  write_raw(s.priv_column().begin(), nonzero);
+  write_raw(nonzero);
+  write_raw(s.priv_data().begin(), nonzero);
+}
+
+void
+OutDataFile::dump(const RSparse &s, const std::string &name)
+{
+  write_tag(name, TAG_RSPARSE);
+  dump_sparse(s);
+}
+
+void
+OutDataFile::dump(const CSparse &s, const std::string &name)
+{
+  write_tag(name, TAG_CSPARSE);
+  dump_sparse(s);
+}
+
 void
 OutDataFile::dump(const double v, const std::string &name)
 {
@@ -24,51 +24,145 @@
 // RAW ROUTINES FOR THE SPARSE-TENSOR PRODUCT
 //
 
-template<typename elt_t>
+/* Product of a row of a sparse matrix with a dense vector. The loop is
+   written so that the compiler may vectorize it using gathers; complex
+   numbers are accumulated as pairs of reals for the same reason. */
+template<typename col_t>
+static inline double
+sparse_row_dot(const double *m, const col_t *c, index n, const double *v)
+{
+    double accum = 0;
+#pragma omp simd reduction(+:accum)
+    for (index j = 0; j < n; j++) {
+	accum += m[j] * v[c[j]];
+    }
+    return accum;
+}
+
+template<typename col_t>
+static inline cdouble
+sparse_row_dot(const cdouble *m, const col_t *c, index n, const cdouble *v)
+{
+    const double *rm = reinterpret_cast<const double *>(m);
+    const double *rv = reinterpret_cast<const double *>(v);
+    double re = 0, im = 0;
+#pragma omp simd reduction(+:re,im)
+    for (index j = 0; j < n; j++) {
+	double mr = rm[2*j], mi = rm[2*j+1];
+	double vr = rv[2*c[j]], vi = rv[2*c[j]+1];
+	re += mr * vr - mi * vi;
+	im += mr * vi + mi * vr;
+    }
+    return to_complex(re, im);
+}
+
+template<typename col_t>
+static inline cdouble
+sparse_row_dot(const double *m, const col_t *c, index n, const cdouble *v)
+{
+    const double *rv = reinterpret_cast<const double *>(v);
+    double re = 0, im = 0;
+#pragma omp simd reduction(+:re,im)
+    for (index j = 0; j < n; j++) {
+	re += m[j] * rv[2*c[j]];
+	im += m[j] * rv[2*c[j]+1];
+    }
+    return to_complex(re, im);
+}
+
+/* dest(i,l) += matrix(i,j) vector(j,l) for the rows i in [i0,i1). Groups of
+   four columns of 'vector' are processed together, so that every element
+   of the sparse matrix is read once per group. */
+template<typename elt_t, typename mat_t, typename col_t>
 static void
-mult_sp_t(elt_t *dest,
-	  const index *row_start, const index *column, const elt_t *matrix,
-	  const elt_t *vector,
-	  index i_len, index j_len, index k_len, index l_len)
+mult_sp_t_rows(elt_t *dest,
+	       const index *row_start, const col_t *column, const mat_t *matrix,
+	       const elt_t *vector,
+	       index i0, index i1, index i_len, index j_len, index l_len)
 {
-    if (k_len == 1) {
-#if 0
-	// dest(i,l) = matrix(i,j) vector(j,l)
-	for (; l_len; l_len--, vector+=j_len) {
-	    for (index i = 0; i < i_len; i++) {
-		elt_t accum = *dest;
-		for (index j = row_start[i]; j < row_start[i+1]; j++) {
-		    accum += matrix[j] * vector[column[j]];
-		}
-		*(dest++) = accum;
+    index l = 0;
+    for (; l + 4 <= l_len; l += 4) {
+	const elt_t *v0 = vector + l*j_len;
+	const elt_t *v1 = v0 + j_len, *v2 = v1 + j_len, *v3 = v2 + j_len;
+	elt_t *d0 = dest + l*i_len;
+	elt_t *d1 = d0 + i_len, *d2 = d1 + i_len, *d3 = d2 + i_len;
+	for (index i = i0; i < i1; i++) {
+	    elt_t a0 = d0[i], a1 = d1[i], a2 = d2[i], a3 = d3[i];
+	    for (index j = row_start[i]; j < row_start[i+1]; j++) {
+		mat_t m = matrix[j];
+		index c = column[j];
+		a0 += m * v0[c];
+		a1 += m * v1[c];
+		a2 += m * v2[c];
+		a3 += m * v3[c];
 	    }
+	    d0[i] = a0; d1[i] = a1; d2[i] = a2; d3[i] = a3;
 	}
-#else
-	for (; l_len; l_len--, vector+=j_len) {
-	    const elt_t *m = matrix;
-	    const index *c = column;
-	    for (index i = 0; i < i_len; i++) {
-		elt_t accum = *dest;
-		for (index j = row_start[i+1] - row_start[i]; j; j--) {
-		    accum += *(m++) * vector[*(c++)];
-		}
-		*(dest++) = accum;
-	    }
+    }
+    for (; l < l_len; l++) {
+	const elt_t *v = vector + l*j_len;
+	elt_t *d = dest + l*i_len;
+	for (index i = i0; i < i1; i++) {
+	    index j = row_start[i];
+	    d[i] += sparse_row_dot(matrix + j, column + j, row_start[i+1] - j, v);
 	}
-#endif
-    } else {
-	// dest(i,k,l) = matrix(i,j) vector(k,j,l)
-	for (index l = 0; l < l_len; l++) {
-	    const elt_t *v = vector + l*(k_len*j_len);
-	    for (index k = 0; k < k_len; k++, v++) {
-		for (index i = 0; i < i_len; i++) {
-		    elt_t accum = *dest;
-		    for (index j = row_start[i]; j < row_start[i+1]; j++) {
-			accum += matrix[j] * v[column[j] * k_len];
-		    }
-		    *(dest++) = accum;
+    }
+}
+
+/* dest(i,k,l) += matrix(i,j) vector(k,j,l) for the rows i in [i0,i1). The
+   contiguous index k of 'vector' is accumulated in a buffer. */
+template<typename elt_t, typename mat_t, typename col_t>
+static void
+mult_sp_t_rows(elt_t *dest,
+	       const index *row_start, const col_t *column, const mat_t *matrix,
+	       const elt_t *vector,
+	       index i0, index i1, index i_len, index j_len, index k_len,
+	       index l_len)
+{
+    std::vector<elt_t> accum(k_len);
+    for (index l = 0; l < l_len; l++) {
+	const elt_t *v = vector + l*(k_len*j_len);
+	elt_t *d = dest + l*(k_len*i_len);
+	for (index i = i0; i < i1; i++) {
+	    for (index k = 0; k < k_len; k++) {
+		accum[k] = d[i + k*i_len];
+	    }
+	    for (index j = row_start[i]; j < row_start[i+1]; j++) {
+		const mat_t m = matrix[j];
+		const elt_t *vj = v + column[j]*k_len;
+		for (index k = 0; k < k_len; k++) {
+		    accum[k] += m * vj[k];
 		}
 	    }
+	    for (index k = 0; k < k_len; k++) {
+		d[i + k*i_len] = accum[k];
+	    }
+	}
+    }
+}
+
+/* dest(i,k,l) += matrix(i,j) vector(k,j,l). Large products are computed in
+   parallel, splitting the rows of the sparse matrix in blocks with about the
+   same number of nonzero elements. */
+template<typename elt_t, typename mat_t, typename col_t>
+static void
+mult_sp_t(elt_t *dest,
+	  const index *row_start, const col_t *column, const mat_t *matrix,
+	  const elt_t *vector,
+	  index i_len, index j_len, index k_len, index l_len)
+{
+    const int blocks = sparse_blocks((row_start[i_len] - row_start[0]) * k_len * l_len);
+    std::vector<index> first_row(blocks + 1);
+    sparse_row_blocks(row_start, i_len, blocks, &first_row[0]);
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+	if (k_len == 1) {
+	    mult_sp_t_rows(dest, row_start, column, matrix, vector,
+			   first_row[b], first_row[b+1], i_len, j_len, l_len);
+	} else {
+	    mult_sp_t_rows(dest, row_start, column, matrix, vector,
+			   first_row[b], first_row[b+1], i_len, j_len, k_len,
+			   l_len);
 	}
     }
 }
@@ -77,9 +171,9 @@ mult_sp_t(elt_t *dest,
 // HIGHER LEVEL INTERFACE
 //
 
-template<typename elt_t>
+template<typename elt_t, class Matrix>
 static inline const Tensor<elt_t>
-do_mmult(const Sparse<elt_t> &m1, const Tensor<elt_t> &m2)
+do_mmult(const Matrix &m1, const Tensor<elt_t> &m2)
 {
     Indices dims(m2.rank());
     index l_len = 1;
@@ -17,6 +17,8 @@
     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 */
 
+#define TENSOR_LOAD_IMPL
+#include <vector>
 #include <tensor/sparse.h>
 
 namespace tensor {
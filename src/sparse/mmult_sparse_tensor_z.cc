@@ -17,6 +17,8 @@
     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 */
 
+#define TENSOR_LOAD_IMPL
+#include <vector>
 #include <tensor/sparse.h>
 
 namespace tensor {
@@ -30,4 +32,12 @@ mmult(const Sparse<cdouble> &m1, const Tensor<cdouble> &m2)
   return do_mmult(m1, m2);
 }
 
+/**Multiply a real sparse matrix with a complex tensor, without converting the
+   matrix to complex form.*/
+const Tensor<cdouble>
+mmult(const Sparse<double> &m1, const Tensor<cdouble> &m2)
+{
+  return do_mmult(m1, m2);
+}
+
 }
@@ -24,25 +24,72 @@
 // RAW ROUTINE FOR THE TENSOR-SPARSE PRODUCT
 //
 
-template<typename elt_t>
+/* dest(i,k,l) += vector(i,j,k) matrix(j,l) for i in [i0,i1) and for the
+   rows j in [j0,j1) of the sparse matrix. */
+template<typename elt_t, typename mat_t, typename col_t>
 static void
-mult_t_sp(elt_t *dest,
-	  const elt_t *vector,
-	  const index *row_start, const index *column, const elt_t *matrix,
-	  index i_len, index j_len, index k_len, index l_len)
+mult_t_sp_range(elt_t *dest,
+		const elt_t *vector,
+		const index *row_start, const col_t *column, const mat_t *matrix,
+		index i0, index i1, index j0, index j1,
+		index i_len, index j_len, index k_len)
 {
-    // dest(i,k,l) = vector(i,j,k) matrix(j,l)
-    for (index j = 0; j < j_len; j++, vector += i_len) {
+    for (index j = j0; j < j1; j++) {
 	for (index x = row_start[j]; x < row_start[j+1]; x++) {
-	    index l = column[x];
-	    elt_t *d = dest + l * (k_len*i_len);
-	    const elt_t *v = vector;
-	    elt_t m = matrix[x];
+	    elt_t *d = dest + column[x] * (k_len*i_len);
+	    const elt_t *v = vector + j*i_len;
+	    const mat_t m = matrix[x];
 	    for (index k = 0; k < k_len; k++) {
-		for (index i = 0; i < i_len; i++, d++) {
-		    *d += *(v++) * m;
+		for (index i = i0; i < i1; i++) {
+		    d[i] += v[i] * m;
 		}
-		v += (j_len-1)*i_len;
+		d += i_len;
+		v += j_len*i_len;
+	    }
+	}
+    }
+}
+
+/* dest(i,k,l) += vector(i,j,k) matrix(j,l). Large products are computed in
+   parallel. When the tensor has many rows, each thread takes a range of
+   them. Otherwise, as in vector-matrix products, the threads take blocks of
+   rows of the sparse matrix with similar number of elements and add their
+   contributions at the end. */
+template<typename elt_t, typename mat_t, typename col_t>
+static void
+mult_t_sp(elt_t *dest,
+	  const elt_t *vector,
+	  const index *row_start, const col_t *column, const mat_t *matrix,
+	  index i_len, index j_len, index k_len, index l_len)
+{
+    const int blocks = sparse_blocks((row_start[j_len] - row_start[0]) * i_len * k_len);
+    if (blocks == 1) {
+	mult_t_sp_range(dest, vector, row_start, column, matrix,
+			0, i_len, 0, j_len, i_len, j_len, k_len);
+    } else if (i_len >= 16 * blocks) {
+#pragma omp parallel for
+	for (int b = 0; b < blocks; b++) {
+	    mult_t_sp_range(dest, vector, row_start, column, matrix,
+			    (i_len * b) / blocks, (i_len * (b+1)) / blocks,
+			    0, j_len, i_len, j_len, k_len);
+	}
+    } else {
+	const index size = i_len * k_len * l_len;
+	std::vector<index> first_row(blocks + 1);
+	sparse_row_blocks(row_start, j_len, blocks, &first_row[0]);
+	std::vector<elt_t> partial((size_t)(blocks - 1) * size,
+				   number_zero<elt_t>());
+#pragma omp parallel for
+	for (int b = 0; b < blocks; b++) {
+	    elt_t *d = b? &partial[(size_t)(b - 1) * size] : dest;
+	    mult_t_sp_range(d, vector, row_start, column, matrix,
+			    0, i_len, first_row[b], first_row[b+1],
+			    i_len, j_len, k_len);
+	}
+#pragma omp parallel for
+	for (index n = 0; n < size; n++) {
+	    for (int b = 1; b < blocks; b++) {
+		dest[n] += partial[(size_t)(b - 1) * size + n];
 	    }
 	}
     }
@@ -52,9 +99,9 @@ mult_t_sp(elt_t *dest,
 // HIGHER LEVEL INTERFACE
 //
 
-template<typename elt_t>
+template<typename elt_t, class Matrix>
 static inline const Tensor<elt_t>
-do_mmult(const Tensor<elt_t> &m1, const Sparse<elt_t> &m2)
+do_mmult(const Tensor<elt_t> &m1, const Matrix &m2)
 {
     index N = m1.rank();
     index i_len = 1;
@@ -63,7 +110,7 @@ do_mmult(const Tensor<elt_t> &m1, const Sparse<elt_t> &m2)
 	dims.at(k) = m1.dimension(k);
 	i_len *= dims[k];
     }
-    index j_len = m1.dimension(-1);
+    index j_len = m1.dimension(N-1);
     index l_len = dims.at(N-1) = m2.columns();
 
     if (j_len != m2.rows()) {
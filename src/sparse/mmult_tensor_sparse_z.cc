@@ -17,6 +17,8 @@
     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 */
 
+#define TENSOR_LOAD_IMPL
+#include <vector>
 #include <tensor/sparse.h>
 
 namespace tensor {
@@ -30,4 +32,12 @@ mmult(const Tensor<cdouble> &m1, const Sparse<cdouble> &m2)
   return do_mmult(m1, m2);
 }
 
+/**Multiply a complex tensor with a real sparse matrix, without converting the
+   matrix to complex form.*/
+const Tensor<cdouble>
+mmult(const Tensor<cdouble> &m1, const Sparse<double> &m2)
+{
+  return do_mmult(m1, m2);
+}
+
 }
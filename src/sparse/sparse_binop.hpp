@@ -20,96 +20,109 @@
 #include <algorithm>
 #include <cassert>
 #include <functional>
+#ifndef TENSOR_LOAD_IMPL
+#define TENSOR_LOAD_IMPL
+#endif
 #include <tensor/sparse.h>
 
 namespace tensor {
 
+  /* Merge a row of m1 with the same row of m2, applying 'op' to the pairs of
+     elements with the same column. Nonzero results are written to
+     'out_column' and 'out_data' when these are not null, and counted. */
+  template<typename T1, typename T2, typename T3, class binop>
+  static inline index
+  sparse_binop_row(const index *c1, const T1 *d1, index l1,
+                   const index *c2, const T2 *d2, index l2,
+                   binop op, index *out_column, T3 *out_data)
+  {
+    index n = 0;
+    while (l1 || l2) {
+      T3 value;
+      index c;
+      if (l2 == 0 || (l1 && *c1 < *c2)) {
+        // There is an element at column c1 on matrix m1, but the
+        // same element at m2 is zero
+        value = op(*d1, number_zero<T2>());
+        c = *c1;
+        l1--; c1++; d1++;
+      } else if (l1 == 0 || *c2 < *c1) {
+        // There is an element at column c2 on matrix m2, but the
+        // same element at m1 is zero
+        value = op(number_zero<T1>(), *d2);
+        c = *c2;
+        l2--; c2++; d2++;
+      } else {
+        // Both elements in m1 and m2 are nonzero.
+        value = op(*d1, *d2);
+        c = *c1;
+        l1--; c1++; d1++;
+        l2--; c2++; d2++;
+      }
+      if (!(value == number_zero<T3>())) {
+        if (out_column) {
+          out_column[n] = c;
+          out_data[n] = value;
+        }
+        n++;
+      }
+    }
+    return n;
+  }
+
+  /* Element-wise operation between sparse matrices. A first pass counts
+     the nonzero elements of every row of the output and a second one
+     writes them, so that the output is allocated once with its exact
+     size. Rows are processed in parallel for large matrices. */
   template<typename T1, typename T2, class binop>
   const Sparse<typename Binop<T1,T2>::type>
   sparse_binop(const Sparse<T1> &m1, const Sparse<T2> &m2, binop op)
   {
     typedef typename Binop<T1,T2>::type T3;
-  
-    size_t rows = m1.rows();
-    size_t cols = m1.columns();
+
+    const index rows = m1.rows();
+    const index cols = m1.columns();
 
     assert(rows == m2.rows() && cols == m2.columns());
 
     if (rows == 0 || cols == 0)
       return Sparse<T3>(rows,cols);
 
-    index max_size = m1.priv_data().size() + m2.priv_data().size();
-    Tensor<T3> data(max_size);
-    Indices column(max_size);
-    Indices row_start(rows + 1);
-
-    typename Tensor<T3>::iterator out_data = data.begin();
-    typename Indices::iterator out_column = column.begin();
-    typename Indices::iterator out_row_start = row_start.begin();
-    typename Tensor<T3>::iterator out_begin = out_data;
+    const index *m1_row_start = m1.priv_row_start().begin();
+    const index *m1_column = m1.priv_column().begin();
+    const T1 *m1_data = m1.priv_data().begin();
+    const index *m2_row_start = m2.priv_row_start().begin();
+    const index *m2_column = m2.priv_column().begin();
+    const T2 *m2_data = m2.priv_data().begin();
 
-    typename Tensor<T1>::const_iterator m1_data = m1.priv_data().begin();
-    typename Indices::const_iterator m1_row_start = m1.priv_row_start().begin();
-    typename Indices::const_iterator m1_column = m1.priv_column().begin();
-
-    typename Tensor<T2>::const_iterator m2_data = m2.priv_data().begin();
-    typename Indices::const_iterator m2_row_start = m2.priv_row_start().begin();
-    typename Indices::const_iterator m2_column = m2.priv_column().begin();
+    Indices row_start(rows + 1);
+    index *out_row_start = row_start.begin();
+    const int blocks = sparse_blocks(m1.length() + m2.length());
+#pragma omp parallel for if (blocks > 1)
+    for (index i = 0; i < rows; i++) {
+      index j1 = m1_row_start[i], j2 = m2_row_start[i];
+      out_row_start[i+1] =
+        sparse_binop_row(m1_column + j1, m1_data + j1, m1_row_start[i+1] - j1,
+                         m2_column + j2, m2_data + j2, m2_row_start[i+1] - j2,
+                         op, (index *)0, (T3 *)0);
+    }
+    out_row_start[0] = 0;
+    for (index i = 0; i < rows; i++)
+      out_row_start[i+1] += out_row_start[i];
 
-    index j1 = *(m1_row_start++);    // data start for this row in M1
-    index l1 = (*m1_row_start) - j1; // # elements in this row in M1
-    index j2 = *(m2_row_start++);    // data start for this row in M2
-    index l2 = (*m2_row_start) - j2; // # elements in this row in M2
-    *out_row_start = 0;
-    while (1) {
-      // We look for the next unprocessed matrix element on this row,
-      // for both matrices. c1 and c2 are the columns associated to
-      // each element on each matrix.
-      index c1 = l1 ? *m1_column : cols;
-      index c2 = l2 ? *m2_column : cols;
-      T3 value;
-      index c;
-      if (c1 < c2) {
-        // There is an element a column c1 on matrix m1, but the
-        // same element at m2 is zero
-        value = op(*m1_data, number_zero<T2>());
-        c = c1;
-        l1--; m1_column++; m1_data++;
-      } else if (c2 < c1) {
-        // There is an element a column c2 on matrix m2, but the
-        // same element at m1 is zero
-        value = op(number_zero<T1>(), *m2_data);
-        c = c2;
-        l2--; m2_column++; m2_data++;
-      } else if (c2 < cols) {
-        // Both elements in m1 and m2 are nonzero.
-        value = op(*m1_data, *m2_data);
-        c = c1;
-        l1--; l2--;
-        m1_column++; m1_data++;
-        m2_column++; m2_data++;
-      } else {
-        // We have processed all elements in this row.
-        out_row_start++;
-        *out_row_start = out_data - out_begin;
-        if (--rows == 0) {
-          break;
-        }
-        j1 = *m1_row_start; m1_row_start++; l1 = (*m1_row_start) - j1;
-        j2 = *m2_row_start; m2_row_start++; l2 = (*m2_row_start) - j2;
-        continue;
-      }
-      if (!(value == number_zero<T3>())) {
-        *(out_data++) = value;
-        *(out_column++) = c;
-      }
+    Indices column(out_row_start[rows]);
+    Tensor<T3> data(out_row_start[rows]);
+    index *out_column = column.begin();
+    T3 *out_data = data.begin();
+#pragma omp parallel for if (blocks > 1)
+    for (index i = 0; i < rows; i++) {
+      index j1 = m1_row_start[i], j2 = m2_row_start[i];
+      sparse_binop_row(m1_column + j1, m1_data + j1, m1_row_start[i+1] - j1,
+                       m2_column + j2, m2_data + j2, m2_row_start[i+1] - j2,
+                       op, out_column + out_row_start[i],
+                       out_data + out_row_start[i]);
     }
-    index j = out_data - out_begin;
-    Indices the_column(j);
-    std::copy(column.begin(), column.begin() + j, the_column.begin());
-    Tensor<T3> the_data(j);
-    std::copy(data.begin(), data.begin() + j, the_data.begin());
-    return Sparse<T3>(m1.dimensions(), row_start, the_column, the_data);
+    return Sparse<T3>(m1.dimensions(), row_start, column, data);
   }
 
 } // namespace tensor
@@ -0,0 +1,204 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef TENSOR_SPARSE_BLOCK_HPP
+#define TENSOR_SPARSE_BLOCK_HPP
+
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <tensor/sparse.h>
+
+namespace tensor {
+
+  //////////////////////////////////////////////////////////////////////
+  // BLOCK COMPRESSED ROW MATRICES
+  //
+
+  template<typename elt_t>
+  BlockSparse<elt_t>::BlockSparse() :
+    dims_(igen << 0 << 0), block_(1), block_row_start_(igen << 0),
+    block_column_(0), data_(0)
+  {
+  }
+
+  /* The blocks are found in two passes over each row of blocks: the first
+     one counts the distinct columns of blocks, the second one sorts them
+     and copies the elements. Rows of blocks are processed in parallel. */
+  template<typename elt_t>
+  BlockSparse<elt_t>::BlockSparse(const Sparse<elt_t> &s, index block) :
+    dims_(s.dimensions()), block_(block), block_row_start_(), block_column_(),
+    data_()
+  {
+    if (block <= 0) {
+      std::cerr << "In BlockSparse(S, block), the block size " << block
+                << " is not positive." << std::endl;
+      abort();
+    }
+    const index rows = s.rows();
+    const index cols = s.columns();
+    const index block_rows = (rows + block - 1) / block;
+    const index block_cols = (cols + block - 1) / block;
+    const index block_size = block * block;
+    const index *row_start = s.priv_row_start().begin();
+    const index *column = s.priv_column().begin();
+    const elt_t *data = s.priv_data().begin();
+
+    block_row_start_ = Indices(block_rows + 1);
+    index *out_row_start = block_row_start_.begin();
+    out_row_start[0] = 0;
+    const int blocks = sparse_blocks(s.length());
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      std::vector<index> mark(block_cols, -1);
+      for (index I = (block_rows * b) / blocks;
+           I < (block_rows * (b+1)) / blocks; I++) {
+        index count = 0;
+        for (index x = row_start[I * block];
+             x < row_start[std::min(rows, (I+1) * block)]; x++) {
+          index J = column[x] / block;
+          if (mark[J] != I) {
+            mark[J] = I;
+            count++;
+          }
+        }
+        out_row_start[I+1] = count;
+      }
+    }
+    for (index I = 0; I < block_rows; I++)
+      out_row_start[I+1] += out_row_start[I];
+
+    block_column_ = Indices(out_row_start[block_rows]);
+    data_ = Tensor<elt_t>(out_row_start[block_rows] * block_size);
+    index *out_column = block_column_.begin();
+    elt_t *out_data = data_.begin();
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      std::vector<index> mark(block_cols, -1);
+      for (index I = (block_rows * b) / blocks;
+           I < (block_rows * (b+1)) / blocks; I++) {
+        const index first = row_start[I * block];
+        const index last = row_start[std::min(rows, (I+1) * block)];
+        index *J = out_column + out_row_start[I];
+        index n = 0;
+        for (index x = first; x < last; x++) {
+          index j = column[x] / block;
+          if (mark[j] != I) {
+            mark[j] = I;
+            J[n++] = j;
+          }
+        }
+        std::sort(J, J + n);
+        // mark[] now gives the position of the block within this row
+        for (index k = 0; k < n; k++)
+          mark[J[k]] = k;
+        elt_t *d = out_data + out_row_start[I] * block_size;
+        std::fill(d, d + n * block_size, number_zero<elt_t>());
+        for (index r = I * block; r < std::min(rows, (I+1) * block); r++) {
+          for (index x = row_start[r]; x < row_start[r+1]; x++) {
+            index j = column[x] / block;
+            d[mark[j] * block_size + (r - I * block) +
+              (column[x] - j * block) * block] = data[x];
+          }
+        }
+        // Reset the marks, which may be confused with later rows
+        for (index k = 0; k < n; k++)
+          mark[J[k]] = -1;
+      }
+    }
+  }
+
+  /* dest(i,l) += matrix(i,j) vector(j,l) for the rows of blocks in [I0,I1).
+     Padding rows and columns of the blocks are zero, but the vector is only
+     read within its bounds. */
+  template<typename elt_t>
+  static void
+  mult_bsr_t_rows(elt_t *dest, const index *block_row_start,
+                  const index *block_column, const elt_t *matrix,
+                  const elt_t *vector, index block, index I0, index I1,
+                  index i_len, index j_len, index l_len)
+  {
+    const index block_size = block * block;
+    std::vector<elt_t> accum(block);
+    elt_t *a = &accum[0];
+    for (index l = 0; l < l_len; l++) {
+      const elt_t *v = vector + l * j_len;
+      elt_t *d = dest + l * i_len;
+      for (index I = I0; I < I1; I++) {
+        std::fill(a, a + block, number_zero<elt_t>());
+        for (index x = block_row_start[I]; x < block_row_start[I+1]; x++) {
+          const elt_t *m = matrix + x * block_size;
+          const index j0 = block_column[x] * block;
+          const index s_len = std::min(block, j_len - j0);
+          for (index s = 0; s < s_len; s++, m += block) {
+            const elt_t vs = v[j0 + s];
+#pragma omp simd
+            for (index r = 0; r < block; r++) {
+              a[r] += m[r] * vs;
+            }
+          }
+        }
+        const index i0 = I * block;
+        for (index r = 0, r_len = std::min(block, i_len - i0); r < r_len; r++) {
+          d[i0 + r] += a[r];
+        }
+      }
+    }
+  }
+
+  template<typename elt_t>
+  static const Tensor<elt_t>
+  do_mmult(const BlockSparse<elt_t> &m1, const Tensor<elt_t> &m2)
+  {
+    Indices dims(m2.rank());
+    index l_len = 1;
+    for (index k = 1, N = m2.rank(); k < N; k++) {
+      dims.at(k) = m2.dimension(k);
+      l_len *= dims[k];
+    }
+    index j_len = m2.dimension(0);
+    index i_len = dims.at(0) = m1.rows();
+
+    if (j_len != m1.columns()) {
+      std::cerr <<
+        "In mmult(S,T), the first index of tensor T does not match the number of\n"
+        "columns in sparse matrix S." << std::endl;
+      abort();
+    }
+
+    Tensor<elt_t> output = Tensor<elt_t>::zeros(dims);
+    const index block = m1.block_size();
+    const index block_rows = m1.priv_block_row_start().size() - 1;
+    const index *block_row_start = m1.priv_block_row_start().begin();
+    const int blocks = sparse_blocks(m1.length() * block * block * l_len);
+    std::vector<index> first_row(blocks + 1);
+    sparse_row_blocks(block_row_start, block_rows, blocks, &first_row[0]);
+    elt_t *dest = output.begin();
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      mult_bsr_t_rows(dest, block_row_start, m1.priv_block_column().begin(),
+                      m1.priv_data().begin(), m2.begin(), block,
+                      first_row[b], first_row[b+1], i_len, j_len, l_len);
+    }
+    return output;
+  }
+
+} // namespace tensor
+
+#endif // TENSOR_SPARSE_BLOCK_HPP
@@ -0,0 +1,60 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef TENSOR_SPARSE_COMPACT_HPP
+#define TENSOR_SPARSE_COMPACT_HPP
+
+#include <limits>
+#include <iostream>
+#include <tensor/sparse.h>
+
+namespace tensor {
+
+  //////////////////////////////////////////////////////////////////////
+  // SPARSE MATRICES WITH 32-BIT COLUMN INDICES
+  //
+
+  template<typename elt_t>
+  CompactSparse<elt_t>::CompactSparse() :
+    dims_(igen << 0 << 0), row_start_(igen << 0), column_(0), data_(0)
+  {
+  }
+
+  template<typename elt_t>
+  CompactSparse<elt_t>::CompactSparse(const Sparse<elt_t> &s) :
+    dims_(s.dimensions()), row_start_(s.priv_row_start()),
+    column_(s.length()), data_(s.priv_data())
+  {
+    if (s.columns() > std::numeric_limits<int>::max()) {
+      std::cerr << "CompactSparse only supports matrices with less than 2^31 "
+        "columns." << std::endl;
+      abort();
+    }
+    const index n = s.length();
+    const index *column = s.priv_column().begin();
+    int *out_column = column_.begin();
+#pragma omp parallel for if (n > TENSOR_SPARSE_PARALLEL_SIZE)
+    for (index i = 0; i < n; i++) {
+      out_column[i] = (int)column[i];
+    }
+  }
+
+} // namespace tensor
+
+#endif // TENSOR_SPARSE_COMPACT_HPP
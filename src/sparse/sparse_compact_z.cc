@@ -0,0 +1,45 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#define TENSOR_LOAD_IMPL
+#include <vector>
+#include "sparse_compact.hpp"
+
+namespace tensor {
+
+#include "mmult_sparse_tensor.h"
+#include "mmult_tensor_sparse.h"
+
+  template class CompactSparse<cdouble>;
+
+  /**Multiply a compact sparse matrix with a tensor, contracting the first index of the tensor.*/
+  const CTensor
+  mmult(const CCompactSparse &m1, const CTensor &m2)
+  {
+    return do_mmult(m1, m2);
+  }
+
+  /**Multiply a tensor with a compact sparse matrix, contracting the last index of the tensor.*/
+  const CTensor
+  mmult(const CTensor &m1, const CCompactSparse &m2)
+  {
+    return do_mmult(m1, m2);
+  }
+
+} // namespace tensor
@@ -0,0 +1,245 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef TENSOR_SPARSE_HERMITIAN_HPP
+#define TENSOR_SPARSE_HERMITIAN_HPP
+
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <tensor/sparse.h>
+#include <tensor/io.h>
+
+namespace tensor {
+
+  //////////////////////////////////////////////////////////////////////
+  // HERMITIAN MATRICES STORED AS THEIR UPPER TRIANGLE
+  //
+
+  template<typename elt_t>
+  HermitianSparse<elt_t>::HermitianSparse() :
+    dims_(igen << 0 << 0), row_start_(igen << 0), column_(0), data_(0)
+  {
+  }
+
+  template<typename elt_t>
+  HermitianSparse<elt_t>::HermitianSparse(const Sparse<elt_t> &s) :
+    dims_(s.dimensions()), row_start_(s.rows() + 1), column_(), data_()
+  {
+    if (s.rows() != s.columns()) {
+      std::cerr << "HermitianSparse requires a square matrix, but got one with "
+                << "dimensions " << s.dimensions() << std::endl;
+      abort();
+    }
+    const index rows = s.rows();
+    const index *row_start = s.priv_row_start().begin();
+    const index *column = s.priv_column().begin();
+    const elt_t *data = s.priv_data().begin();
+
+    // Columns are sorted: the upper triangle of row i starts at column i
+    std::vector<index> first(rows);
+    index *out_row_start = row_start_.begin();
+    out_row_start[0] = 0;
+    for (index i = 0; i < rows; i++) {
+      first[i] = std::lower_bound(column + row_start[i], column + row_start[i+1],
+                                  i) - column;
+      out_row_start[i+1] = out_row_start[i] + (row_start[i+1] - first[i]);
+    }
+    column_ = Indices(out_row_start[rows]);
+    data_ = Tensor<elt_t>(out_row_start[rows]);
+    index *out_column = column_.begin();
+    elt_t *out_data = data_.begin();
+    const int blocks = sparse_blocks(out_row_start[rows]);
+#pragma omp parallel for if (blocks > 1)
+    for (index i = 0; i < rows; i++) {
+      std::copy(column + first[i], column + row_start[i+1],
+                out_column + out_row_start[i]);
+      std::copy(data + first[i], data + row_start[i+1],
+                out_data + out_row_start[i]);
+    }
+  }
+
+  /* dest(i,l) += H(i,j) vector(j,l) for the rows i in [i0,i1) of the upper
+     triangle. The transposed elements, H(j,i) = conj(H(i,j)) with j > i, are
+     added to lower[(j - lower_first) + lower_rows * l], which may be 'dest'
+     itself when there is a single thread. */
+  template<typename elt_t>
+  static void
+  mult_herm_t_rows(elt_t *dest, elt_t *lower, index lower_first,
+                   index lower_rows, const index *row_start,
+                   const index *column, const elt_t *matrix,
+                   const elt_t *vector, index i0, index i1, index i_len,
+                   index l_len)
+  {
+    for (index l = 0; l < l_len; l++) {
+      const elt_t *v = vector + l * i_len;
+      elt_t *d = dest + l * i_len;
+      elt_t *t = lower + l * lower_rows - lower_first;
+      for (index i = i0; i < i1; i++) {
+        const elt_t vi = v[i];
+        elt_t accum = number_zero<elt_t>();
+        index x = row_start[i];
+        if (x < row_start[i+1] && column[x] == i) {
+          accum = matrix[x++] * vi;
+        }
+        for (; x < row_start[i+1]; x++) {
+          const index j = column[x];
+          const elt_t h = matrix[x];
+          accum += h * v[j];
+          t[j] += tensor::conj(h) * vi;
+        }
+        d[i] += accum;
+      }
+    }
+  }
+
+  /* With several threads, every block of rows of the upper triangle writes
+     its own rows of the output and accumulates the lower triangle in a
+     private buffer. The buffer of a block only spans the rows its elements
+     reach, from its first row to its largest column. Buffers are then added
+     to the output. */
+  template<typename elt_t>
+  static const Tensor<elt_t>
+  do_mmult(const HermitianSparse<elt_t> &m1, const Tensor<elt_t> &m2)
+  {
+    Indices dims(m2.rank());
+    index l_len = 1;
+    for (index k = 1, N = m2.rank(); k < N; k++) {
+      dims.at(k) = m2.dimension(k);
+      l_len *= dims[k];
+    }
+    index j_len = m2.dimension(0);
+    index i_len = dims.at(0) = m1.rows();
+
+    if (j_len != m1.columns()) {
+      std::cerr <<
+        "In mmult(S,T), the first index of tensor T does not match the number of\n"
+        "columns in sparse matrix S." << std::endl;
+      abort();
+    }
+
+    Tensor<elt_t> output = Tensor<elt_t>::zeros(dims);
+    const index *row_start = m1.priv_row_start().begin();
+    const index *column = m1.priv_column().begin();
+    const elt_t *matrix = m1.priv_data().begin();
+    const elt_t *vector = m2.begin();
+    elt_t *dest = output.begin();
+    int blocks = sparse_blocks(m1.length() * l_len);
+    std::vector<index> first_row(blocks + 1), last_row(blocks), offset(blocks + 1);
+    if (blocks > 1) {
+      sparse_row_blocks(row_start, i_len, blocks, &first_row[0]);
+      offset[0] = 0;
+      for (int b = 0; b < blocks; b++) {
+        index last = first_row[b];
+        for (index i = first_row[b]; i < first_row[b+1]; i++)
+          if (row_start[i] < row_start[i+1])
+            last = std::max(last, column[row_start[i+1] - 1] + 1);
+        last_row[b] = last;
+        offset[b+1] = offset[b] + (last - first_row[b]) * l_len;
+      }
+      // The buffers must not cost more memory traffic than the matrix
+      if (offset[blocks] > m1.length() * l_len)
+        blocks = 1;
+    }
+    if (blocks == 1) {
+      mult_herm_t_rows(dest, dest, 0, i_len, row_start, column, matrix, vector,
+                       0, i_len, i_len, l_len);
+    } else {
+      std::vector<elt_t> lower(offset[blocks], number_zero<elt_t>());
+#pragma omp parallel for
+      for (int b = 0; b < blocks; b++) {
+        mult_herm_t_rows(dest, &lower[0] + offset[b], first_row[b],
+                         last_row[b] - first_row[b], row_start, column,
+                         matrix, vector, first_row[b], first_row[b+1],
+                         i_len, l_len);
+      }
+#pragma omp parallel for
+      for (index i = 0; i < i_len; i++) {
+        for (int b = 0; b < blocks && first_row[b] <= i; b++) {
+          if (i < last_row[b]) {
+            const index rows = last_row[b] - first_row[b];
+            const elt_t *t = &lower[0] + offset[b] + (i - first_row[b]);
+            for (index l = 0; l < l_len; l++)
+              dest[i + l * i_len] += t[l * rows];
+          }
+        }
+      }
+    }
+    return output;
+  }
+
+  /* dest(i,l) += vector(i,j) H(j,l), using H(l,j) = conj(H(j,l)). Threads
+     take ranges of the index i. */
+  template<typename elt_t>
+  static const Tensor<elt_t>
+  do_mmult(const Tensor<elt_t> &m1, const HermitianSparse<elt_t> &m2)
+  {
+    index N = m1.rank();
+    index i_len = 1;
+    Indices dims(N);
+    for (index k = 0; k < N-1; k++) {
+      dims.at(k) = m1.dimension(k);
+      i_len *= dims[k];
+    }
+    index j_len = m1.dimension(N-1);
+    dims.at(N-1) = m2.columns();
+
+    if (j_len != m2.rows()) {
+      std::cerr <<
+        "In mmult(T,S), the last index of tensor T does not match the number of rows\n"
+        "in sparse matrix S." << std::endl;
+      abort();
+    }
+
+    Tensor<elt_t> output = Tensor<elt_t>::zeros(dims);
+    const index *row_start = m2.priv_row_start().begin();
+    const index *column = m2.priv_column().begin();
+    const elt_t *matrix = m2.priv_data().begin();
+    const elt_t *vector = m1.begin();
+    elt_t *dest = output.begin();
+    int blocks = sparse_blocks(m2.length() * i_len);
+    if (i_len < 16 * blocks)
+      blocks = 1;
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      const index i0 = (i_len * b) / blocks, i1 = (i_len * (b+1)) / blocks;
+      for (index j = 0; j < j_len; j++) {
+        for (index x = row_start[j]; x < row_start[j+1]; x++) {
+          const index l = column[x];
+          const elt_t h = matrix[x];
+          elt_t *d = dest + l * i_len;
+          const elt_t *v = vector + j * i_len;
+          for (index i = i0; i < i1; i++)
+            d[i] += v[i] * h;
+          if (l != j) {
+            const elt_t hc = tensor::conj(h);
+            d = dest + j * i_len;
+            v = vector + l * i_len;
+            for (index i = i0; i < i1; i++)
+              d[i] += v[i] * hc;
+          }
+        }
+      }
+    }
+    return output;
+  }
+
+} // namespace tensor
+
+#endif // TENSOR_SPARSE_HERMITIAN_HPP
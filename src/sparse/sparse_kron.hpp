@@ -63,4 +63,105 @@ namespace tensor {
     return Sparse<elt_t>(output_dims, output_row_start, output_column, output_data);
   }
 
+  //////////////////////////////////////////////////////////////////////
+  // SUM OF OPERATORS ON A TENSOR PRODUCT SPACE
+  //
+
+  template<bool fill, typename elt_t>
+  static inline void
+  kron_sum_push(index &n, index c, const elt_t &v, index *column, elt_t *data)
+  {
+    if (!(v == number_zero<elt_t>())) {
+      if (fill) {
+        column[n] = c;
+        data[n] = v;
+      }
+      n++;
+    }
+  }
+
+  /* Row [i,j] of C = kron(eye(s2), s1) + kron(s2, eye(s1)), that is
+     C([i,j],[k,l]) = s1(i,k) delta(j,l) + delta(i,k) s2(j,l)
+     Columns come out ordered and zeros are dropped. When 'fill' is false,
+     only the number of elements is computed. */
+  template<bool fill, typename elt_t>
+  static index
+  kron_sum_row(const Sparse<elt_t> &s1, const Sparse<elt_t> &s2, index i, index j,
+               index *column, elt_t *data)
+  {
+    const index cols1 = s1.columns();
+    const index *c1 = s1.priv_column().begin();
+    const index *c2 = s2.priv_column().begin();
+    const elt_t *d1 = s1.priv_data().begin();
+    const elt_t *d2 = s2.priv_data().begin();
+    index x1 = s1.priv_row_start()[i], end1 = s1.priv_row_start()[i+1];
+    index x2 = s2.priv_row_start()[j], end2 = s2.priv_row_start()[j+1];
+    if (j >= s2.columns()) end1 = x1; // delta(j,l) == 0
+    if (i >= cols1) end2 = x2;        // delta(i,k) == 0
+    index n = 0;
+    // Elements of s2 in blocks l < j
+    for (; x2 < end2 && c2[x2] < j; x2++)
+      kron_sum_push<fill>(n, i + cols1 * c2[x2], d2[x2], column, data);
+    // Block l == j, where s1(i,:) meets s2(j,j) on the diagonal k == i
+    bool diagonal = (x2 < end2 && c2[x2] == j);
+    for (; x1 < end1; x1++) {
+      index k = c1[x1];
+      if (diagonal && k >= i) {
+        diagonal = false;
+        if (k == i) {
+          kron_sum_push<fill>(n, k + cols1 * j, d1[x1] + d2[x2++], column, data);
+          continue;
+        }
+        kron_sum_push<fill>(n, i + cols1 * j, d2[x2++], column, data);
+      }
+      kron_sum_push<fill>(n, k + cols1 * j, d1[x1], column, data);
+    }
+    if (diagonal)
+      kron_sum_push<fill>(n, i + cols1 * j, d2[x2++], column, data);
+    // Elements of s2 in blocks l > j
+    for (; x2 < end2; x2++)
+      kron_sum_push<fill>(n, i + cols1 * c2[x2], d2[x2], column, data);
+    return n;
+  }
+
+  /* kron(eye(s2), s1) + kron(s2, eye(s1)) built in two passes over the rows:
+     one to count the nonzero elements and one to fill them in. */
+  template<typename elt_t>
+  static const Sparse<elt_t> do_kron_sum(const Sparse<elt_t> &s1, const Sparse<elt_t> &s2)
+  {
+    index rows1 = s1.rows();
+    index rows2 = s2.rows();
+    index total_rows = rows1 * rows2;
+    index total_cols = s1.columns() * s2.columns();
+
+    if (total_rows == 0 || total_cols == 0)
+      return Sparse<elt_t>(total_rows, total_cols);
+
+    Indices output_row_start(total_rows+1);
+    typename Indices::iterator out_row_start = output_row_start.begin();
+    *out_row_start = 0;
+    for (index j = 0, r = 0; j < rows2; j++) {
+      for (index i = 0; i < rows1; i++, r++) {
+        out_row_start[r+1] = out_row_start[r] +
+          kron_sum_row<false,elt_t>(s1, s2, i, j, 0, 0);
+      }
+    }
+
+    index number_nonzero = out_row_start[total_rows];
+    Tensor<elt_t> output_data(number_nonzero);
+    Indices output_column(number_nonzero);
+    Indices output_dims(igen << total_rows << total_cols);
+    if (number_nonzero) {
+      index *out_column = output_column.begin();
+      elt_t *out_data = output_data.begin();
+      for (index j = 0, r = 0; j < rows2; j++) {
+        for (index i = 0; i < rows1; i++, r++) {
+          index x = out_row_start[r];
+          kron_sum_row<true,elt_t>(s1, s2, i, j, out_column + x, out_data + x);
+        }
+      }
+    }
+    return Sparse<elt_t>(output_dims, output_row_start, output_column, output_data);
+  }
+
 } // namespace tensor
@@ -0,0 +1,168 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef TENSOR_SPARSE_MMULT_HPP
+#define TENSOR_SPARSE_MMULT_HPP
+
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <tensor/sparse.h>
+
+namespace tensor {
+
+  //////////////////////////////////////////////////////////////////////
+  // PRODUCT OF SPARSE MATRICES
+  //
+
+  /* Gustavson's algorithm: row i of the product is the combination of the
+     rows of m2 selected by the elements of row i of m1. A symbolic pass
+     counts the distinct columns of every row, so that the output is
+     allocated exactly, and a numeric pass accumulates the values in a
+     dense work array. Exact zeros produced by cancellation are dropped, as
+     everywhere else in the library. Rows are split among threads in blocks with about
+     the same number of multiplications. */
+  template<typename elt_t, typename t1, typename t2>
+  static const Sparse<elt_t>
+  do_mmult(const Sparse<t1> &m1, const Sparse<t2> &m2)
+  {
+    const index rows = m1.rows();
+    const index cols = m2.columns();
+    if (m1.columns() != m2.rows()) {
+      std::cerr <<
+        "In mmult(A,B), the number of columns of sparse matrix A does not\n"
+        "match the number of rows of sparse matrix B." << std::endl;
+      abort();
+    }
+    const index *row_start1 = m1.priv_row_start().begin();
+    const index *column1 = m1.priv_column().begin();
+    const t1 *data1 = m1.priv_data().begin();
+    const index *row_start2 = m2.priv_row_start().begin();
+    const index *column2 = m2.priv_column().begin();
+    const t2 *data2 = m2.priv_data().begin();
+
+    // Number of multiplications up to every row
+    std::vector<index> work(rows + 1);
+    work[0] = 0;
+    for (index i = 0; i < rows; i++) {
+      index w = 0;
+      for (index x = row_start1[i]; x < row_start1[i+1]; x++)
+        w += row_start2[column1[x]+1] - row_start2[column1[x]];
+      work[i+1] = work[i] + w;
+    }
+    const int blocks = sparse_blocks(work[rows]);
+    std::vector<index> first_row(blocks + 1);
+    sparse_row_blocks(&work[0], rows, blocks, &first_row[0]);
+
+    // Symbolic pass: mark[j] == i when column j already appeared in row i
+    Indices output_row_start(rows + 1);
+    index *out_row_start = output_row_start.begin();
+    out_row_start[0] = 0;
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      std::vector<index> mark(cols, -1);
+      for (index i = first_row[b]; i < first_row[b+1]; i++) {
+        index count = 0;
+        for (index x = row_start1[i]; x < row_start1[i+1]; x++) {
+          index k = column1[x];
+          for (index y = row_start2[k]; y < row_start2[k+1]; y++) {
+            index j = column2[y];
+            if (mark[j] != i) {
+              mark[j] = i;
+              count++;
+            }
+          }
+        }
+        out_row_start[i+1] = count;
+      }
+    }
+    for (index i = 0; i < rows; i++)
+      out_row_start[i+1] += out_row_start[i];
+
+    // Numeric pass, which also counts the elements kept in every row
+    Indices output_row_start_kept(rows + 1);
+    index *kept = output_row_start_kept.begin();
+    kept[0] = 0;
+    Indices output_column(out_row_start[rows]);
+    Tensor<elt_t> output_data(out_row_start[rows]);
+    index *out_column = output_column.begin();
+    elt_t *out_data = output_data.begin();
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      std::vector<index> mark(cols, -1);
+      std::vector<elt_t> accum(cols);
+      for (index i = first_row[b]; i < first_row[b+1]; i++) {
+        index *c = out_column + out_row_start[i];
+        index n = 0;
+        for (index x = row_start1[i]; x < row_start1[i+1]; x++) {
+          index k = column1[x];
+          t1 a = data1[x];
+          for (index y = row_start2[k]; y < row_start2[k+1]; y++) {
+            index j = column2[y];
+            if (mark[j] != i) {
+              mark[j] = i;
+              accum[j] = a * data2[y];
+              c[n++] = j;
+            } else {
+              accum[j] += a * data2[y];
+            }
+          }
+        }
+        std::sort(c, c + n);
+        // Zeros produced by cancellation are not stored
+        elt_t *d = out_data + out_row_start[i];
+        index m = 0;
+        for (index x = 0; x < n; x++) {
+          elt_t v = accum[c[x]];
+          if (!(v == number_zero<elt_t>())) {
+            c[m] = c[x];
+            d[m++] = v;
+          }
+        }
+        kept[i+1] = m;
+      }
+    }
+    for (index i = 0; i < rows; i++)
+      kept[i+1] += kept[i];
+    if (kept[rows] == out_row_start[rows])
+      return Sparse<elt_t>(igen << rows << cols, output_row_start,
+                           output_column, output_data);
+
+    // Compaction of the rows which lost some elements
+    Indices compact_column(kept[rows]);
+    Tensor<elt_t> compact_data(kept[rows]);
+    index *new_column = compact_column.begin();
+    elt_t *new_data = compact_data.begin();
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      for (index i = first_row[b]; i < first_row[b+1]; i++) {
+        index n = kept[i+1] - kept[i];
+        std::copy(out_column + out_row_start[i],
+                  out_column + out_row_start[i] + n, new_column + kept[i]);
+        std::copy(out_data + out_row_start[i],
+                  out_data + out_row_start[i] + n, new_data + kept[i]);
+      }
+    }
+    return Sparse<elt_t>(igen << rows << cols, output_row_start_kept,
+                         compact_column, compact_data);
+  }
+
+} // namespace tensor
+
+#endif // TENSOR_SPARSE_MMULT_HPP
@@ -0,0 +1,278 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef TENSOR_SPARSE_PATTERN_HPP
+#define TENSOR_SPARSE_PATTERN_HPP
+
+#include <vector>
+#include <iostream>
+#include <tensor/sparse.h>
+#include <tensor/io.h>
+
+namespace tensor {
+
+  //////////////////////////////////////////////////////////////////////
+  // OPERATIONS THAT REUSE THE PATTERN OF A SPARSE MATRIX
+  //
+
+  /* Find the position of each element of a row, with columns c[0..l), in
+     the row [first,last) of a pattern. Positions are written to 'position'
+     when not null. Returns false if some column is not in the pattern. */
+  static inline bool
+  sparse_row_positions(const index *pattern, index first, index last,
+                       const index *c, index l, index *position)
+  {
+    for (index x = 0; x < l; x++) {
+      while (first < last && pattern[first] < c[x])
+        first++;
+      if (first == last || pattern[first] != c[x])
+        return false;
+      if (position)
+        position[x] = first;
+      first++;
+    }
+    return true;
+  }
+
+  /* Merge the columns of two rows, writing them to 'output' if not null.
+     Returns the number of distinct columns. */
+  static inline index
+  sparse_row_union(const index *c1, index l1, const index *c2, index l2,
+                   index *output)
+  {
+    index n = 0;
+    while (l1 || l2) {
+      index c;
+      if (l2 == 0 || (l1 && *c1 < *c2)) {
+        c = *c1; c1++; l1--;
+      } else if (l1 == 0 || *c2 < *c1) {
+        c = *c2; c2++; l2--;
+      } else {
+        c = *c1; c1++; l1--; c2++; l2--;
+      }
+      if (output)
+        output[n] = c;
+      n++;
+    }
+    return n;
+  }
+
+  static void
+  check_same_dimensions(const char *where, const Indices &d1, const Indices &d2)
+  {
+    if (!all_equal(d1, d2)) {
+      std::cerr << "In " << where << ", sparse matrices have different "
+                << "dimensions " << d1 << " and " << d2 << std::endl;
+      abort();
+    }
+  }
+
+  /* Copy of S without the elements that are exactly zero. */
+  template<typename elt_t>
+  static const Sparse<elt_t>
+  sparse_drop_zeros(const Sparse<elt_t> &S, int blocks)
+  {
+    const index rows = S.rows();
+    const index *row_start = S.priv_row_start().begin();
+    const index *column = S.priv_column().begin();
+    const elt_t *data = S.priv_data().begin();
+    Indices output_row_start(rows + 1);
+    index *out_row_start = output_row_start.begin();
+    out_row_start[0] = 0;
+#pragma omp parallel for if (blocks > 1)
+    for (index i = 0; i < rows; i++) {
+      index n = 0;
+      for (index x = row_start[i]; x < row_start[i+1]; x++)
+        n += !(data[x] == number_zero<elt_t>());
+      out_row_start[i+1] = n;
+    }
+    for (index i = 0; i < rows; i++)
+      out_row_start[i+1] += out_row_start[i];
+    Indices output_column(out_row_start[rows]);
+    Tensor<elt_t> output_data(out_row_start[rows]);
+    index *out_column = output_column.begin();
+    elt_t *out_data = output_data.begin();
+#pragma omp parallel for if (blocks > 1)
+    for (index i = 0; i < rows; i++) {
+      for (index x = row_start[i], y = out_row_start[i]; x < row_start[i+1]; x++) {
+        if (!(data[x] == number_zero<elt_t>())) {
+          out_column[y] = column[x];
+          out_data[y++] = data[x];
+        }
+      }
+    }
+    return Sparse<elt_t>(S.dimensions(), output_row_start, output_column,
+                         output_data);
+  }
+
+  template<typename elt_t>
+  static void
+  do_axpy(Sparse<elt_t> &A, elt_t alpha, const Sparse<elt_t> &B)
+  {
+    check_same_dimensions("axpy(A,alpha,B)", A.dimensions(), B.dimensions());
+    const index rows = A.rows();
+    const index *a_row_start = A.priv_row_start().begin();
+    const index *a_column = A.priv_column().begin();
+    const index *b_row_start = B.priv_row_start().begin();
+    const index *b_column = B.priv_column().begin();
+    const elt_t *b_data = B.priv_data().begin();
+
+    const int blocks = sparse_blocks(A.length() + B.length());
+    bool subset = true;
+#pragma omp parallel for if (blocks > 1) reduction(&&:subset)
+    for (index i = 0; i < rows; i++) {
+      subset = subset &&
+        sparse_row_positions(a_column, a_row_start[i], a_row_start[i+1],
+                             b_column + b_row_start[i],
+                             b_row_start[i+1] - b_row_start[i], 0);
+    }
+    if (!subset) {
+      A = A + alpha * B;
+      return;
+    }
+
+    elt_t *a_data = A.data_.begin();
+    bool cancelled = false;
+#pragma omp parallel for if (blocks > 1) reduction(||:cancelled)
+    for (index i = 0; i < rows; i++) {
+      index x = a_row_start[i];
+      for (index y = b_row_start[i]; y < b_row_start[i+1]; y++) {
+        while (a_column[x] < b_column[y])
+          x++;
+        elt_t &a = a_data[x++];
+        a += alpha * b_data[y];
+        cancelled = cancelled || (a == number_zero<elt_t>());
+      }
+    }
+    // As in A + alpha * B, elements that cancel are not stored
+    if (cancelled)
+      A = sparse_drop_zeros(A, blocks);
+  }
+
+  template<typename elt_t>
+  SparseCombination<elt_t>::SparseCombination(const Sparse<elt_t> &S0) :
+    dims_(S0.dimensions()), row_start_(S0.priv_row_start()),
+    column_(S0.priv_column()), terms_(), positions_()
+  {
+    add(S0);
+  }
+
+  template<typename elt_t>
+  SparseCombination<elt_t>::SparseCombination(const Sparse<elt_t> &S0,
+                                              const Sparse<elt_t> &S1) :
+    dims_(S0.dimensions()), row_start_(S0.priv_row_start()),
+    column_(S0.priv_column()), terms_(), positions_()
+  {
+    add(S0);
+    add(S1);
+  }
+
+  /* The pattern of the combination grows to include the new term and the
+     positions of all terms are computed again. */
+  template<typename elt_t>
+  void SparseCombination<elt_t>::add(const Sparse<elt_t> &S)
+  {
+    check_same_dimensions("SparseCombination::add()", dims_, S.dimensions());
+    const index rows = S.rows();
+    const index *s_row_start = S.priv_row_start().begin();
+    const index *s_column = S.priv_column().begin();
+    const index *p_row_start = row_start_.begin();
+    const index *p_column = column_.begin();
+
+    Indices row_start(rows + 1), column;
+    index *out_row_start = row_start.begin();
+    out_row_start[0] = 0;
+    for (index i = 0; i < rows; i++) {
+      out_row_start[i+1] = out_row_start[i] +
+        sparse_row_union(p_column + p_row_start[i],
+                         p_row_start[i+1] - p_row_start[i],
+                         s_column + s_row_start[i],
+                         s_row_start[i+1] - s_row_start[i], 0);
+    }
+    column = Indices(out_row_start[rows]);
+    index *out_column = column.begin();
+    for (index i = 0; i < rows; i++) {
+      sparse_row_union(p_column + p_row_start[i],
+                       p_row_start[i+1] - p_row_start[i],
+                       s_column + s_row_start[i],
+                       s_row_start[i+1] - s_row_start[i],
+                       out_column + out_row_start[i]);
+    }
+    row_start_ = row_start;
+    column_ = column;
+
+    terms_.push_back(S);
+    positions_.resize(terms_.size());
+    for (size_t t = 0; t < terms_.size(); t++) {
+      const index *t_row_start = terms_[t].priv_row_start().begin();
+      const index *t_column = terms_[t].priv_column().begin();
+      positions_[t] = Indices(terms_[t].length());
+      index *position = positions_[t].begin();
+      for (index i = 0; i < rows; i++) {
+        sparse_row_positions(out_column, out_row_start[i], out_row_start[i+1],
+                             t_column + t_row_start[i],
+                             t_row_start[i+1] - t_row_start[i],
+                             position + t_row_start[i]);
+      }
+    }
+  }
+
+  template<typename elt_t>
+  const Sparse<elt_t>
+  SparseCombination<elt_t>::operator()(const Tensor<elt_t> &c) const
+  {
+    if (c.size() != (index)terms_.size()) {
+      std::cerr << "In SparseCombination, got " << c.size()
+                << " coefficients for " << terms_.size() << " terms."
+                << std::endl;
+      abort();
+    }
+    const index n = column_.size();
+    Tensor<elt_t> data(n);
+    elt_t *out_data = data.begin();
+    const int blocks = sparse_blocks(n);
+#pragma omp parallel for if (blocks > 1)
+    for (index x = 0; x < n; x++)
+      out_data[x] = number_zero<elt_t>();
+    for (size_t t = 0; t < terms_.size(); t++) {
+      const elt_t alpha = c[t];
+      const index *position = positions_[t].begin();
+      const elt_t *t_data = terms_[t].priv_data().begin();
+      const index l = terms_[t].length();
+      // Positions of the elements of a term are all different
+#pragma omp parallel for if (blocks > 1)
+      for (index x = 0; x < l; x++)
+        out_data[position[x]] += alpha * t_data[x];
+    }
+    return Sparse<elt_t>(dims_, row_start_, column_, data);
+  }
+
+  template<typename elt_t>
+  const Sparse<elt_t>
+  SparseCombination<elt_t>::operator()(elt_t c0, elt_t c1) const
+  {
+    Tensor<elt_t> c(2);
+    c.at(0) = c0;
+    c.at(1) = c1;
+    return (*this)(c);
+  }
+
+} // namespace tensor
+
+#endif // TENSOR_SPARSE_PATTERN_HPP
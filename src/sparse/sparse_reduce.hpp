@@ -0,0 +1,145 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef TENSOR_SPARSE_REDUCE_HPP
+#define TENSOR_SPARSE_REDUCE_HPP
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <tensor/sparse.h>
+
+namespace tensor {
+
+  //////////////////////////////////////////////////////////////////////
+  // REDUCTIONS AND DIAGONALS THAT WORK ON THE SPARSE REPRESENTATION
+  //
+
+  template<typename elt_t>
+  static const Tensor<elt_t>
+  sparse_take_diag(const Sparse<elt_t> &s, int which)
+  {
+    const index rows = s.rows();
+    const index cols = s.columns();
+    if ((rows || cols) && (which <= -rows || which >= cols)) {
+      std::cerr << "In take_diag(S, which), WHICH has a value " << which
+                << " which exceeds the size of the matrix" << std::endl;
+      abort();
+    }
+    const index r0 = (which < 0)? -which : 0;
+    const index c0 = (which < 0)? 0 : which;
+    const index l = std::max<index>(0, std::min(rows - r0, cols - c0));
+    Tensor<elt_t> output(l);
+    if (l == 0)
+      return output;
+    const index *row_start = s.priv_row_start().begin();
+    const index *column = s.priv_column().begin();
+    const elt_t *data = s.priv_data().begin();
+    elt_t *diagonal = output.begin();
+    // Each row has its element on the diagonal found by bisection
+    const int blocks = sparse_blocks(l);
+#pragma omp parallel for if (blocks > 1)
+    for (index k = 0; k < l; k++) {
+      const index *first = column + row_start[r0 + k];
+      const index *last = column + row_start[r0 + k + 1];
+      const index *p = std::lower_bound(first, last, c0 + k);
+      diagonal[k] = (p != last && *p == c0 + k)?
+        data[p - column] : number_zero<elt_t>();
+    }
+    return output;
+  }
+
+  template<typename elt_t>
+  static const Tensor<elt_t>
+  sparse_sum(const Sparse<elt_t> &s, int which)
+  {
+    if (which < 0)
+      which += 2;
+    if (which != 0 && which != 1) {
+      std::cerr << "In sum(S, which), WHICH has a value " << which
+                << " which is not a dimension of the matrix" << std::endl;
+      abort();
+    }
+    const index rows = s.rows();
+    const index cols = s.columns();
+    const index *row_start = s.priv_row_start().begin();
+    const index *column = s.priv_column().begin();
+    const elt_t *data = s.priv_data().begin();
+    const index nonzero = s.length();
+    const int blocks = sparse_blocks(nonzero);
+    if (which == 1) {
+      // Sum over columns: one output element per row
+      Tensor<elt_t> output(rows);
+      elt_t *out = output.begin();
+#pragma omp parallel for if (blocks > 1)
+      for (index i = 0; i < rows; i++) {
+        elt_t aux = number_zero<elt_t>();
+        for (index x = row_start[i]; x < row_start[i+1]; x++)
+          aux += data[x];
+        out[i] = aux;
+      }
+      return output;
+    }
+    // Sum over rows: consecutive blocks of elements are accumulated
+    // in private vectors, which are added at the end.
+    std::vector<elt_t> partial((size_t)blocks * cols, number_zero<elt_t>());
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      elt_t *out = &partial[(size_t)b * cols];
+      for (index x = (nonzero * b) / blocks; x < (nonzero * (b+1)) / blocks; x++)
+        out[column[x]] += data[x];
+    }
+    Tensor<elt_t> output(cols);
+    std::copy(partial.begin(), partial.begin() + cols, output.begin());
+    for (int b = 1; b < blocks; b++) {
+      const elt_t *in = &partial[(size_t)b * cols];
+      for (index j = 0; j < cols; j++)
+        output.at(j) += in[j];
+    }
+    return output;
+  }
+
+  template<typename elt_t>
+  static double
+  sparse_matrix_norminf(const Sparse<elt_t> &s)
+  {
+    const index rows = s.rows();
+    const index *row_start = s.priv_row_start().begin();
+    const elt_t *data = s.priv_data().begin();
+    const int blocks = sparse_blocks(s.length());
+    std::vector<double> row_max(blocks, 0.0);
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      double output = 0.0;
+      for (index i = (rows * b) / blocks; i < (rows * (b+1)) / blocks; i++) {
+        double aux = 0.0;
+        for (index x = row_start[i]; x < row_start[i+1]; x++)
+          aux += std::abs(data[x]);
+        if (output < aux)
+          output = aux;
+      }
+      row_max[b] = output;
+    }
+    return *std::max_element(row_max.begin(), row_max.end());
+  }
+
+} // namespace tensor
+
+#endif // TENSOR_SPARSE_REDUCE_HPP
@@ -0,0 +1,68 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#define TENSOR_LOAD_IMPL
+#include "sparse_reduce.hpp"
+
+namespace tensor {
+
+  /**Return the given diagonal of a sparse matrix as a vector.*/
+  const RTensor
+  take_diag(const RSparse &s, int which)
+  {
+    return sparse_take_diag(s, which);
+  }
+
+  /**Trace of a sparse matrix.*/
+  double
+  trace(const RSparse &s)
+  {
+    RTensor d = sparse_take_diag(s, 0);
+    return d.size()? sum(d) : number_zero<double>();
+  }
+
+  /**Return the sum of all elements in a sparse matrix.*/
+  double
+  sum(const RSparse &s)
+  {
+    return s.length()? sum(s.priv_data()) : number_zero<double>();
+  }
+
+  /**Sum a sparse matrix along the given dimension.*/
+  const RTensor
+  sum(const RSparse &s, int which)
+  {
+    return sparse_sum(s, which);
+  }
+
+  /**Frobenius norm of a sparse matrix.*/
+  double
+  norm2(const RSparse &s)
+  {
+    return norm2(s.priv_data());
+  }
+
+  /**Largest sum of the absolute values of the elements in a row.*/
+  double
+  matrix_norminf(const RSparse &s)
+  {
+    return sparse_matrix_norminf(s);
+  }
+
+} // namespace tensor
@@ -0,0 +1,232 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef TENSOR_SPARSE_REORDER_HPP
+#define TENSOR_SPARSE_REORDER_HPP
+
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <tensor/sparse.h>
+
+namespace tensor {
+
+  //////////////////////////////////////////////////////////////////////
+  // BANDWIDTH REDUCTION
+  //
+
+  /* Graph of the symmetrized pattern of a square matrix, A + A^T, without
+     the diagonal. The neighbors of node i are adjacency[start[i]..start[i+1]). */
+  template<typename elt_t>
+  static void
+  sparse_graph(const Sparse<elt_t> &s, std::vector<index> &start,
+               std::vector<index> &adjacency)
+  {
+    const index n = s.rows();
+    const index *row_start = s.priv_row_start().begin();
+    const index *column = s.priv_column().begin();
+    std::vector<index> offset(n + 1, 0);
+    for (index i = 0; i < n; i++) {
+      for (index x = row_start[i]; x < row_start[i+1]; x++) {
+        index j = column[x];
+        if (j != i) {
+          offset[i+1]++;
+          offset[j+1]++;
+        }
+      }
+    }
+    for (index i = 0; i < n; i++)
+      offset[i+1] += offset[i];
+    std::vector<index> next(offset.begin(), offset.end() - 1);
+    std::vector<index> edges(offset[n]);
+    for (index i = 0; i < n; i++) {
+      for (index x = row_start[i]; x < row_start[i+1]; x++) {
+        index j = column[x];
+        if (j != i) {
+          edges[next[i]++] = j;
+          edges[next[j]++] = i;
+        }
+      }
+    }
+    // Sort the neighbors, dropping the edges that appear both in A and in A^T
+    start.resize(n + 1);
+    adjacency.clear();
+    adjacency.reserve(edges.size());
+    start[0] = 0;
+    for (index i = 0; i < n; i++) {
+      std::vector<index>::iterator first = edges.begin() + offset[i];
+      std::vector<index>::iterator last = edges.begin() + offset[i+1];
+      std::sort(first, last);
+      adjacency.insert(adjacency.end(), first, std::unique(first, last));
+      start[i+1] = adjacency.size();
+    }
+  }
+
+  /* Breadth first search from 'root', as in the Cuthill-McKee ordering: the
+     neighbors of each node are visited by increasing degree. Nodes are
+     written to order[n], order[n+1]... and the function returns the
+     position after the last one. It also outputs the number of levels and
+     a node of lowest degree in the last level. */
+  static index
+  sparse_bfs(const std::vector<index> &start, const std::vector<index> &adjacency,
+             index root, std::vector<index> &order, index n,
+             std::vector<index> &mark, index stamp, index *depth, index *last)
+  {
+    index head = n, level_begin = n;
+    order[n++] = root;
+    mark[root] = stamp;
+    index level_end = n;
+    *depth = 1;
+    while (head < n) {
+      if (head == level_end) {
+        level_begin = head;
+        level_end = n;
+        ++*depth;
+      }
+      index node = order[head++];
+      index begin = n;
+      for (index x = start[node]; x < start[node+1]; x++) {
+        index j = adjacency[x];
+        if (mark[j] != stamp) {
+          mark[j] = stamp;
+          order[n++] = j;
+        }
+      }
+      // Insertion sort by degree: lists of neighbors are short
+      for (index a = begin + 1; a < n; a++) {
+        index j = order[a], d = start[j+1] - start[j], b = a;
+        for (; b > begin && start[order[b-1]+1] - start[order[b-1]] > d; b--)
+          order[b] = order[b-1];
+        order[b] = j;
+      }
+    }
+    *last = order[level_begin];
+    for (index a = level_begin; a < n; a++) {
+      index j = order[a];
+      if (start[j+1] - start[j] < start[*last+1] - start[*last])
+        *last = j;
+    }
+    return n;
+  }
+
+  template<typename elt_t>
+  static const Indices
+  sparse_rcm(const Sparse<elt_t> &s)
+  {
+    if (s.rows() != s.columns()) {
+      std::cerr << "In reverse_cuthill_mckee(S), S is not a square matrix."
+                << std::endl;
+      abort();
+    }
+    const index n = s.rows();
+    std::vector<index> start, adjacency;
+    sparse_graph(s, start, adjacency);
+
+    // Components are started from their nodes of lowest degree
+    std::vector<index> by_degree(n);
+    {
+      std::vector<std::pair<index,index> > aux(n);
+      for (index i = 0; i < n; i++)
+        aux[i] = std::make_pair(start[i+1] - start[i], i);
+      std::sort(aux.begin(), aux.end());
+      for (index i = 0; i < n; i++)
+        by_degree[i] = aux[i].second;
+    }
+
+    std::vector<index> order(n), mark(n, -1);
+    index placed = 0, stamp = 0;
+    for (index k = 0; k < n; k++) {
+      index root = by_degree[k];
+      if (mark[root] >= 0)
+        continue;
+      // Look for a pseudo-peripheral node, which gives deep level
+      // structures with few nodes in each level (George and Liu).
+      index depth, last;
+      sparse_bfs(start, adjacency, root, order, placed, mark, stamp++,
+                 &depth, &last);
+      while (true) {
+        index new_depth, new_last;
+        sparse_bfs(start, adjacency, last, order, placed, mark, stamp++,
+                   &new_depth, &new_last);
+        if (new_depth <= depth)
+          break;
+        root = last;
+        depth = new_depth;
+        last = new_last;
+      }
+      placed = sparse_bfs(start, adjacency, root, order, placed, mark,
+                          stamp++, &depth, &last);
+    }
+    Indices output(n);
+    std::copy(order.rbegin(), order.rend(), output.begin());
+    return output;
+  }
+
+  template<typename elt_t>
+  static index
+  sparse_bandwidth(const Sparse<elt_t> &s)
+  {
+    const index *row_start = s.priv_row_start().begin();
+    const index *column = s.priv_column().begin();
+    index output = 0;
+    for (index i = 0; i < s.rows(); i++) {
+      for (index x = row_start[i]; x < row_start[i+1]; x++) {
+        index d = std::abs(column[x] - i);
+        if (d > output)
+          output = d;
+      }
+    }
+    return output;
+  }
+
+  /* output(k,...) = v(rows[k],...) */
+  template<typename elt_t>
+  static const Tensor<elt_t>
+  dense_take_rows(const Tensor<elt_t> &v, const Indices &rows)
+  {
+    const index n = v.dimension(0);
+    const index m = rows.size();
+    for (index k = 0; k < m; k++) {
+      if (rows[k] < 0 || rows[k] >= n) {
+        std::cerr << "In take_rows(T, rows), index " << rows[k]
+                  << " exceeds the size " << n << " of the tensor."
+                  << std::endl;
+        abort();
+      }
+    }
+    Indices dims(v.rank());
+    index other = 1;
+    dims.at(0) = m;
+    for (index d = 1; d < (index)v.rank(); d++)
+      other *= (dims.at(d) = v.dimension(d));
+    Tensor<elt_t> output(dims);
+    elt_t *out = output.begin();
+    const elt_t *in = v.begin();
+    const int blocks = sparse_blocks(m * other);
+#pragma omp parallel for if (blocks > 1)
+    for (index l = 0; l < other; l++) {
+      for (index k = 0; k < m; k++)
+        out[k + m * l] = in[rows[k] + n * l];
+    }
+    return output;
+  }
+
+} // namespace tensor
+
+#endif // TENSOR_SPARSE_REORDER_HPP
@@ -0,0 +1,54 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#define TENSOR_LOAD_IMPL
+#include "sparse_reorder.hpp"
+#include "sparse_slice.hpp"
+
+namespace tensor {
+
+  /**Reverse Cuthill-McKee ordering of a square sparse matrix.*/
+  const Indices
+  reverse_cuthill_mckee(const CSparse &s)
+  {
+    return sparse_rcm(s);
+  }
+
+  /**Return s(p,p), the square matrix with rows and columns reordered.*/
+  const CSparse
+  permute(const CSparse &s, const Indices &p)
+  {
+    return sparse_take_columns(sparse_take_rows(s, p), p);
+  }
+
+  /**Largest distance between a nonzero element and the diagonal.*/
+  index
+  bandwidth(const CSparse &s)
+  {
+    return sparse_bandwidth(s);
+  }
+
+  /**Return the tensor with its first index reordered, t(rows,...).*/
+  const CTensor
+  take_rows(const CTensor &t, const Indices &rows)
+  {
+    return dense_take_rows(t, rows);
+  }
+
+} // namespace tensor
@@ -0,0 +1,217 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef TENSOR_SPARSE_SLICE_HPP
+#define TENSOR_SPARSE_SLICE_HPP
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <iostream>
+#include <tensor/sparse.h>
+
+namespace tensor {
+
+  //////////////////////////////////////////////////////////////////////
+  // VIEWS OF CONSECUTIVE ROWS
+  //
+
+  /* Number of rows of SparseView(s, first, last), checked before any member
+     of the view is built from them. */
+  template<typename elt_t>
+  static index
+  view_rows(const Sparse<elt_t> &s, index first, index last)
+  {
+    if (first < 0 || last < first || last > s.rows()) {
+      std::cerr << "In SparseView(S, first, last), the rows [" << first
+                << "," << last << ") are not within the " << s.rows()
+                << " rows of S." << std::endl;
+      abort();
+    }
+    return last - first;
+  }
+
+  template<typename elt_t>
+  SparseView<elt_t>::SparseView(const Sparse<elt_t> &s, index first, index last) :
+    dims_(igen << view_rows(s, first, last) << s.columns()), first_(first),
+    row_start_(last - first + 1), column_(s.priv_column()),
+    data_(s.priv_data())
+  {
+    std::copy(s.priv_row_start().begin() + first,
+              s.priv_row_start().begin() + last + 1, row_start_.begin());
+  }
+
+  template<typename elt_t>
+  elt_t SparseView<elt_t>::operator()(index row, index col) const
+  {
+    row = normalize_index(row, rows());
+    col = normalize_index(col, columns());
+    const index *first = column_.begin() + row_start_[row];
+    const index *last = column_.begin() + row_start_[row+1];
+    const index *p = std::lower_bound(first, last, col);
+    if (p != last && *p == col)
+      return data_[p - column_.begin()];
+    return number_zero<elt_t>();
+  }
+
+  //////////////////////////////////////////////////////////////////////
+  // SLICES OF ROWS AND COLUMNS
+  //
+
+  static void
+  check_slice(const char *where, const Indices &ndx, index limit)
+  {
+    for (index i = 0; i < (index)ndx.size(); i++) {
+      if (ndx[i] < 0 || ndx[i] >= limit) {
+        std::cerr << "In " << where << ", index " << ndx[i]
+                  << " exceeds the size " << limit << " of the matrix."
+                  << std::endl;
+        abort();
+      }
+    }
+  }
+
+  template<typename elt_t>
+  static const Sparse<elt_t>
+  sparse_take_rows(const Sparse<elt_t> &s, const Indices &rows)
+  {
+    check_slice("take_rows(S, rows)", rows, s.rows());
+    const index nrows = rows.size();
+    const index *row_start = s.priv_row_start().begin();
+    const index *column = s.priv_column().begin();
+    const elt_t *data = s.priv_data().begin();
+
+    Indices out_row_start(nrows + 1);
+    out_row_start.at(0) = 0;
+    for (index i = 0; i < nrows; i++) {
+      index r = rows[i];
+      out_row_start.at(i+1) = out_row_start[i] + row_start[r+1] - row_start[r];
+    }
+    const index nonzero = out_row_start[nrows];
+    Indices out_column(nonzero);
+    Tensor<elt_t> out_data(nonzero);
+    index *oc = out_column.begin();
+    elt_t *od = out_data.begin();
+    const index *os = out_row_start.begin();
+    const int blocks = sparse_blocks(nonzero);
+#pragma omp parallel for if (blocks > 1)
+    for (index i = 0; i < nrows; i++) {
+      index r = rows[i];
+      std::copy(column + row_start[r], column + row_start[r+1], oc + os[i]);
+      std::copy(data + row_start[r], data + row_start[r+1], od + os[i]);
+    }
+    return Sparse<elt_t>(igen << nrows << s.columns(), out_row_start,
+                         out_column, out_data);
+  }
+
+  template<typename elt_t>
+  static inline bool
+  sparse_first_less(const std::pair<index,elt_t> &a,
+                    const std::pair<index,elt_t> &b)
+  {
+    return a.first < b.first;
+  }
+
+  template<typename elt_t>
+  static const Sparse<elt_t>
+  sparse_take_columns(const Sparse<elt_t> &s, const Indices &columns)
+  {
+    check_slice("take_columns(S, columns)", columns, s.columns());
+    const index nrows = s.rows();
+    const index ncols = columns.size();
+    const index *row_start = s.priv_row_start().begin();
+    const index *column = s.priv_column().begin();
+    const elt_t *data = s.priv_data().begin();
+
+    // For each column of S, the new columns where it goes, in increasing order
+    std::vector<index> target_start(s.columns() + 1, 0);
+    std::vector<index> target(ncols);
+    for (index k = 0; k < ncols; k++)
+      target_start[columns[k] + 1]++;
+    for (index c = 0; c < s.columns(); c++)
+      target_start[c + 1] += target_start[c];
+    {
+      std::vector<index> next(target_start.begin(), target_start.end() - 1);
+      for (index k = 0; k < ncols; k++)
+        target[next[columns[k]]++] = k;
+    }
+    // Increasing column lists preserve the order of the elements in a row
+    bool sorted = true;
+    for (index k = 1; k < ncols; k++) {
+      if (columns[k] <= columns[k-1]) {
+        sorted = false;
+        break;
+      }
+    }
+
+    // First pass: size of each row
+    Indices out_row_start(nrows + 1);
+    index *os = out_row_start.begin();
+    os[0] = 0;
+    const int blocks = sparse_blocks(s.length());
+#pragma omp parallel for if (blocks > 1)
+    for (index i = 0; i < nrows; i++) {
+      index l = 0;
+      for (index x = row_start[i]; x < row_start[i+1]; x++)
+        l += target_start[column[x] + 1] - target_start[column[x]];
+      os[i+1] = l;
+    }
+    for (index i = 0; i < nrows; i++)
+      os[i+1] += os[i];
+
+    // Second pass: copy the elements, sorting the rows if needed
+    const index nonzero = os[nrows];
+    Indices out_column(nonzero);
+    Tensor<elt_t> out_data(nonzero);
+    index *oc = out_column.begin();
+    elt_t *od = out_data.begin();
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      std::vector<std::pair<index,elt_t> > buffer;
+      for (index i = (nrows * b) / blocks; i < (nrows * (b+1)) / blocks; i++) {
+        if (sorted) {
+          index n = os[i];
+          for (index x = row_start[i]; x < row_start[i+1]; x++) {
+            for (index t = target_start[column[x]]; t < target_start[column[x]+1]; t++) {
+              oc[n] = target[t];
+              od[n] = data[x];
+              n++;
+            }
+          }
+        } else {
+          buffer.clear();
+          for (index x = row_start[i]; x < row_start[i+1]; x++) {
+            for (index t = target_start[column[x]]; t < target_start[column[x]+1]; t++)
+              buffer.push_back(std::make_pair(target[t], data[x]));
+          }
+          std::sort(buffer.begin(), buffer.end(), sparse_first_less<elt_t>);
+          for (index n = os[i], k = 0; k < (index)buffer.size(); k++, n++) {
+            oc[n] = buffer[k].first;
+            od[n] = buffer[k].second;
+          }
+        }
+      }
+    }
+    return Sparse<elt_t>(igen << nrows << ncols, out_row_start,
+                         out_column, out_data);
+  }
+
+} // namespace tensor
+
+#endif // TENSOR_SPARSE_SLICE_HPP
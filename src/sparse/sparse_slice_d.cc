@@ -0,0 +1,68 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#define TENSOR_LOAD_IMPL
+#include <vector>
+#include "sparse_slice.hpp"
+
+namespace tensor {
+
+#include "mmult_sparse_tensor.h"
+#include "mmult_tensor_sparse.h"
+
+  template class SparseView<double>;
+
+  /**Multiply a view of a sparse matrix with a tensor, contracting the first
+     index of the tensor.*/
+  const RTensor
+  mmult(const RSparseView &m1, const RTensor &m2)
+  {
+    return do_mmult(m1, m2);
+  }
+
+  /**Multiply a tensor with a view of a sparse matrix, contracting the last
+     index of the tensor.*/
+  const RTensor
+  mmult(const RTensor &m1, const RSparseView &m2)
+  {
+    return do_mmult(m1, m2);
+  }
+
+  /**Return the rows of a sparse matrix in the given order.*/
+  const RSparse
+  take_rows(const RSparse &s, const Indices &rows)
+  {
+    return sparse_take_rows(s, rows);
+  }
+
+  /**Return the columns of a sparse matrix in the given order.*/
+  const RSparse
+  take_columns(const RSparse &s, const Indices &columns)
+  {
+    return sparse_take_columns(s, columns);
+  }
+
+  /**Return the matrix s(rows,columns).*/
+  const RSparse
+  submatrix(const RSparse &s, const Indices &rows, const Indices &columns)
+  {
+    return sparse_take_columns(sparse_take_rows(s, rows), columns);
+  }
+
+} // namespace tensor
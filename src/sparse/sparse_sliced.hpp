@@ -0,0 +1,184 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef TENSOR_SPARSE_SLICED_HPP
+#define TENSOR_SPARSE_SLICED_HPP
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <iostream>
+#include <tensor/sparse.h>
+
+namespace tensor {
+
+  //////////////////////////////////////////////////////////////////////
+  // SELL-C-SIGMA MATRICES
+  //
+
+  template<typename elt_t>
+  SlicedSparse<elt_t>::SlicedSparse() :
+    dims_(igen << 0 << 0), chunk_(1), row_(0), chunk_start_(igen << 0),
+    column_(0), data_(0)
+  {
+  }
+
+  template<typename elt_t>
+  SlicedSparse<elt_t>::SlicedSparse(const Sparse<elt_t> &s, index chunk,
+                                    index sigma) :
+    dims_(s.dimensions()), chunk_(chunk), row_(s.rows()), chunk_start_(),
+    column_(), data_()
+  {
+    assert(chunk > 0 && sigma > 0);
+    if (s.columns() > std::numeric_limits<int>::max()) {
+      std::cerr << "SlicedSparse only supports matrices with less than 2^31 "
+        "columns." << std::endl;
+      abort();
+    }
+    const index rows = s.rows();
+    const index chunks = (rows + chunk - 1) / chunk;
+    const index *row_start = s.priv_row_start().begin();
+    const index *column = s.priv_column().begin();
+    const elt_t *data = s.priv_data().begin();
+
+    // Sort rows by decreasing length within each window
+    index *row = row_.begin();
+    {
+      std::vector<std::pair<index,index> > order(rows);
+      for (index i = 0; i < rows; i++)
+        order[i] = std::make_pair(row_start[i] - row_start[i+1], i);
+      for (index w = 0; w < rows; w += sigma) {
+        std::sort(order.begin() + w, order.begin() + std::min(rows, w + sigma));
+      }
+      for (index i = 0; i < rows; i++)
+        row[i] = order[i].second;
+    }
+
+    // Each chunk is as long as its longest row
+    chunk_start_ = Indices(chunks + 1);
+    index *start = chunk_start_.begin();
+    start[0] = 0;
+    for (index c = 0; c < chunks; c++) {
+      index length = 0;
+      for (index p = c * chunk; p < std::min(rows, (c+1) * chunk); p++)
+        length = std::max(length, row_start[row[p]+1] - row_start[row[p]]);
+      start[c+1] = start[c] + length * chunk;
+    }
+
+    column_ = CompactIndices(start[chunks]);
+    data_ = Tensor<elt_t>(start[chunks]);
+    int *out_column = column_.begin();
+    elt_t *out_data = data_.begin();
+    const int blocks = sparse_blocks(start[chunks]);
+#pragma omp parallel for if (blocks > 1)
+    for (index c = 0; c < chunks; c++) {
+      const index length = (start[c+1] - start[c]) / chunk;
+      for (index r = 0; r < chunk; r++) {
+        index p = c * chunk + r, x = 0, n = 0;
+        if (p < rows) {
+          x = row_start[row[p]];
+          n = row_start[row[p]+1] - x;
+        }
+        for (index j = 0; j < length; j++) {
+          index q = start[c] + j * chunk + r;
+          if (j < n) {
+            out_column[q] = column[x + j];
+            out_data[q] = data[x + j];
+          } else {
+            out_column[q] = 0;
+            out_data[q] = number_zero<elt_t>();
+          }
+        }
+      }
+    }
+  }
+
+  /* dest(i,l) += matrix(i,j) vector(j,l) for the chunks in [c0,c1). The
+     rows of a chunk are accumulated together, which the compiler turns
+     into SIMD operations with gathers from the vector. */
+  template<typename elt_t>
+  static void
+  mult_sell_t_chunks(elt_t *dest, const index *row, const index *chunk_start,
+                     const int *column, const elt_t *matrix,
+                     const elt_t *vector, index chunk, index c0, index c1,
+                     index i_len, index j_len, index l_len)
+  {
+    std::vector<elt_t> accum(chunk);
+    elt_t *a = &accum[0];
+    for (index l = 0; l < l_len; l++) {
+      const elt_t *v = vector + l * j_len;
+      elt_t *d = dest + l * i_len;
+      for (index c = c0; c < c1; c++) {
+        std::fill(a, a + chunk, number_zero<elt_t>());
+        for (index x = chunk_start[c]; x < chunk_start[c+1]; x += chunk) {
+          const int *col = column + x;
+          const elt_t *m = matrix + x;
+#pragma omp simd
+          for (index r = 0; r < chunk; r++) {
+            a[r] += m[r] * v[col[r]];
+          }
+        }
+        for (index r = 0, p = c * chunk; r < chunk && p < i_len; r++, p++) {
+          d[row[p]] += a[r];
+        }
+      }
+    }
+  }
+
+  template<typename elt_t>
+  static const Tensor<elt_t>
+  do_mmult(const SlicedSparse<elt_t> &m1, const Tensor<elt_t> &m2)
+  {
+    Indices dims(m2.rank());
+    index l_len = 1;
+    for (index k = 1, N = m2.rank(); k < N; k++) {
+      dims.at(k) = m2.dimension(k);
+      l_len *= dims[k];
+    }
+    index j_len = m2.dimension(0);
+    index i_len = dims.at(0) = m1.rows();
+
+    if (j_len != m1.columns()) {
+      std::cerr <<
+        "In mmult(S,T), the first index of tensor T does not match the number of\n"
+        "columns in sparse matrix S." << std::endl;
+      abort();
+    }
+
+    Tensor<elt_t> output = Tensor<elt_t>::zeros(dims);
+    const index chunks = m1.priv_chunk_start().size() - 1;
+    const index *chunk_start = m1.priv_chunk_start().begin();
+    const int blocks = sparse_blocks(m1.length() * l_len);
+    std::vector<index> first_chunk(blocks + 1);
+    sparse_row_blocks(chunk_start, chunks, blocks, &first_chunk[0]);
+    elt_t *dest = output.begin();
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      mult_sell_t_chunks(dest, m1.priv_row().begin(), chunk_start,
+                         m1.priv_column().begin(), m1.priv_data().begin(),
+                         m2.begin(), m1.chunk_size(),
+                         first_chunk[b], first_chunk[b+1], i_len, j_len, l_len);
+    }
+    return output;
+  }
+
+} // namespace tensor
+
+#endif // TENSOR_SPARSE_SLICED_HPP
@@ -0,0 +1,103 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef TENSOR_SPARSE_TRANSPOSE_HPP
+#define TENSOR_SPARSE_TRANSPOSE_HPP
+
+#include <vector>
+#include <algorithm>
+#include <tensor/sparse.h>
+
+namespace tensor {
+
+  //////////////////////////////////////////////////////////////////////
+  // TRANSPOSE AND ADJOINT OF SPARSE MATRICES
+  //
+
+  /* Counting sort of the elements by column. Each block of rows counts
+     how many elements it has in each column; a prefix sum over columns
+     and blocks then tells every block where to write its elements, so
+     that the rows of the output remain ordered. */
+  template<typename elt_t, bool conjugate>
+  static const Sparse<elt_t>
+  do_transpose(const Sparse<elt_t> &s)
+  {
+    const index rows = s.rows();
+    const index cols = s.columns();
+    const index nonzero = s.length();
+    Indices output_row_start(cols + 1);
+    Indices output_column(nonzero);
+    Tensor<elt_t> output_data(nonzero);
+    Indices output_dims(igen << cols << rows);
+
+    std::fill(output_row_start.begin(), output_row_start.end(), 0);
+    if (nonzero == 0)
+      return Sparse<elt_t>(output_dims, output_row_start, output_column,
+                           output_data);
+
+    const index *row_start = s.priv_row_start().begin();
+    const index *column = s.priv_column().begin();
+    const elt_t *data = s.priv_data().begin();
+    index *out_row_start = output_row_start.begin();
+    index *out_column = output_column.begin();
+    elt_t *out_data = output_data.begin();
+
+    // Split the rows in blocks with about the same number of elements. Each
+    // block needs a counter per column, so there are never more blocks than
+    // elements per column.
+    const int blocks = std::min<index>(sparse_blocks(nonzero),
+                                       std::max<index>(1, nonzero / cols));
+    std::vector<index> first_row(blocks + 1);
+    sparse_row_blocks(row_start, rows, blocks, &first_row[0]);
+
+    // offset[b*cols + c] is where block b writes its next element of column c
+    std::vector<index> offset((size_t)blocks * cols, 0);
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      index *count = &offset[(size_t)b * cols];
+      for (index x = row_start[first_row[b]]; x < row_start[first_row[b+1]]; x++)
+        count[column[x]]++;
+    }
+    for (index c = 0, position = 0; c < cols; c++) {
+      for (int b = 0; b < blocks; b++) {
+        index &n = offset[(size_t)b * cols + c];
+        index aux = n;
+        n = position;
+        position += aux;
+      }
+      out_row_start[c+1] = position;
+    }
+#pragma omp parallel for if (blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+      index *next = &offset[(size_t)b * cols];
+      for (index r = first_row[b]; r < first_row[b+1]; r++) {
+        for (index x = row_start[r]; x < row_start[r+1]; x++) {
+          index p = next[column[x]]++;
+          out_column[p] = r;
+          out_data[p] = conjugate? tensor::conj(data[x]) : data[x];
+        }
+      }
+    }
+    return Sparse<elt_t>(output_dims, output_row_start, output_column,
+                         output_data);
+  }
+
+} // namespace tensor
+
+#endif // TENSOR_SPARSE_TRANSPOSE_HPP
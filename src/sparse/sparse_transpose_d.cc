@@ -17,20 +17,15 @@
     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 */
 
-#include <tensor/sparse.h>
+#define TENSOR_LOAD_IMPL
+#include "sparse_transpose.hpp"
 
 namespace tensor {
 
-  const Indices sparse_rows(const Indices &row_start, const Indices &column);
-
   const RSparse
   transpose(const RSparse &s)
   {
-    return RSparse(s.priv_column(),
-		   sparse_rows(s.priv_row_start(), s.priv_column()),
-		   s.priv_data(),
-                   s.columns(),
-                   s.rows());
+    return do_transpose<double,false>(s);
   }
 
 } // namespace tensor
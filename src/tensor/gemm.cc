@@ -20,9 +20,16 @@
 #ifndef TENSOR_GEMM_CC
 #define TENSOR_GEMM_CC
 
+/*
+ * Besides the BLAS operations 'N', 'T' and 'C', gemm() accepts 'R', which
+ * conjugates a matrix without transposing it. OpenBLAS implements it
+ * natively; with other libraries the matrix is conjugated into a copy.
+ */
+
 #ifdef TENSOR_USE_ESSL
 #include <essl.h>
 #endif
+#include <vector>
 #include <tensor/tensor_blas.h>
 
 namespace blas {
@@ -31,6 +38,8 @@ namespace blas {
                    double alpha, const double *A, integer lda, const double *B,
                    integer ldb, double beta, double *C, integer ldc)
   {
+    if (op1 == 'R') op1 = 'N';
+    if (op2 == 'R') op2 = 'N';
 #ifdef TENSOR_USE_ESSL
     dgemm(&op1, &op2, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
 #endif
@@ -49,6 +58,25 @@ namespace blas {
                    const tensor::cdouble *B, integer ldb, const tensor::cdouble &beta,
                    tensor::cdouble *C, integer ldc)
   {
+#ifndef TENSOR_USE_OPENBLAS
+    if (op1 == 'R' || op2 == 'R') {
+      std::vector<tensor::cdouble> aux;
+      if (op1 == 'R') {
+        aux.resize(m * k);
+        for (integer l = 0; l < k; l++)
+          for (integer i = 0; i < m; i++)
+            aux[i + l * m] = tensor::conj(A[i + l * lda]);
+        gemm('N', op2, m, n, k, alpha, &aux[0], m, B, ldb, beta, C, ldc);
+      } else {
+        aux.resize(k * n);
+        for (integer j = 0; j < n; j++)
+          for (integer l = 0; l < k; l++)
+            aux[l + j * k] = tensor::conj(B[l + j * ldb]);
+        gemm(op1, 'N', m, n, k, alpha, A, lda, &aux[0], k, beta, C, ldc);
+      }
+      return;
+    }
+#endif
 #ifdef TENSOR_USE_ESSL
     zgemm(&op1, &op2, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
 #endif
@@ -78,6 +106,123 @@ namespace blas {
 #endif
   }
 
+  //////////////////////////////////////////////////////////////////////
+  // SMALL MATRIX PRODUCTS
+  //
+  // When the product is very small, e.g. when contracting the indices of a
+  // spin or a qubit, the overhead of calling BLAS dominates the arithmetic.
+  // small_gemm() has the same interface as gemm(), but below a size of
+  // TENSOR_SMALL_GEMM_SIZE it uses loops which the compiler unrolls for the
+  // common lengths 1 to 4 of the contracted index.
+  //
+
+#ifndef TENSOR_SMALL_GEMM_SIZE
+#define TENSOR_SMALL_GEMM_SIZE 256
+#endif
+
+  template<char op, typename elt_t>
+  inline elt_t small_gemm_elt(const elt_t *A, integer lda, integer i, integer l)
+  {
+    if (op == 'N') return A[i + l*lda];
+    if (op == 'T') return A[l + i*lda];
+    if (op == 'R') return tensor::conj(A[i + l*lda]);
+    return tensor::conj(A[l + i*lda]);
+  }
+
+  /* C(m,n) = alpha * op1(A)(m,k) * op2(B)(k,n) + beta * C(m,n), where
+     k == K, unless K == 0, in which case the length is only known at
+     runtime. */
+  template<int K, char op1, char op2, typename elt_t>
+  void small_gemm_kernel(integer m, integer n, integer k, const elt_t &alpha,
+                         const elt_t *A, integer lda, const elt_t *B, integer ldb,
+                         const elt_t &beta, elt_t *C, integer ldc)
+  {
+    const elt_t zero = tensor::number_zero<elt_t>();
+    if (K) k = K;
+    for (integer j = 0; j < n; j++, C += ldc) {
+      elt_t b[K? K : 1];
+      if (K) {
+        for (integer l = 0; l < K; l++)
+          b[l] = alpha * small_gemm_elt<op2>(B, ldb, l, j);
+      }
+      if (!(beta == zero)) {
+        for (integer i = 0; i < m; i++)
+          C[i] *= beta;
+      }
+      for (integer i = 0; i < m; i++) {
+        elt_t c = zero;
+        if (K) {
+          for (integer l = 0; l < K; l++)
+            c += small_gemm_elt<op1>(A, lda, i, l) * b[l];
+        } else {
+          for (integer l = 0; l < k; l++)
+            c += small_gemm_elt<op1>(A, lda, i, l) * small_gemm_elt<op2>(B, ldb, l, j);
+          c *= alpha;
+        }
+        if (beta == zero)
+          C[i] = c;
+        else
+          C[i] += c;
+      }
+    }
+  }
+
+  template<int K, typename elt_t>
+  inline void small_gemm_ops(char op1, char op2, integer m, integer n, integer k,
+                             const elt_t &alpha, const elt_t *A, integer lda,
+                             const elt_t *B, integer ldb, const elt_t &beta,
+                             elt_t *C, integer ldc)
+  {
+#define TENSOR_SMALL_GEMM_CASE(o1, o2)                                  \
+    if (op1 == o1 && op2 == o2) {                                       \
+      small_gemm_kernel<K,o1,o2,elt_t>(m, n, k, alpha, A, lda, B, ldb,  \
+                                       beta, C, ldc);                   \
+      return;                                                           \
+    }
+    TENSOR_SMALL_GEMM_CASE('N', 'N');
+    TENSOR_SMALL_GEMM_CASE('N', 'T');
+    TENSOR_SMALL_GEMM_CASE('N', 'C');
+    TENSOR_SMALL_GEMM_CASE('T', 'N');
+    TENSOR_SMALL_GEMM_CASE('T', 'T');
+    TENSOR_SMALL_GEMM_CASE('T', 'C');
+    TENSOR_SMALL_GEMM_CASE('C', 'N');
+    TENSOR_SMALL_GEMM_CASE('C', 'T');
+    TENSOR_SMALL_GEMM_CASE('C', 'C');
+    TENSOR_SMALL_GEMM_CASE('R', 'N');
+    TENSOR_SMALL_GEMM_CASE('R', 'T');
+#undef TENSOR_SMALL_GEMM_CASE
+    gemm(op1, op2, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+  }
+
+  template<typename elt_t>
+  inline void small_gemm(char op1, char op2, integer m, integer n, integer k,
+                         const elt_t &alpha, const elt_t *A, integer lda,
+                         const elt_t *B, integer ldb, const elt_t &beta,
+                         elt_t *C, integer ldc)
+  {
+    // The product is computed in double: m * n * k overflows blas::integer
+    if ((double)m * (double)n * (double)k > TENSOR_SMALL_GEMM_SIZE) {
+      gemm(op1, op2, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+      return;
+    }
+    switch (k) {
+    case 1:
+      small_gemm_ops<1>(op1, op2, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+      break;
+    case 2:
+      small_gemm_ops<2>(op1, op2, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+      break;
+    case 3:
+      small_gemm_ops<3>(op1, op2, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+      break;
+    case 4:
+      small_gemm_ops<4>(op1, op2, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+      break;
+    default:
+      small_gemm_ops<0>(op1, op2, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+    }
+  }
+
 }
 
 #endif
@@ -23,12 +23,19 @@
 namespace tensor {
 
   template<typename n> inline
-  const Tensor<n> do_adjoint(const Tensor<n> &a)
+  void do_adjoint_into(Tensor<n> &b, const Tensor<n> &a)
   {
     assert(a.rank() == 2);
+    if (&b == &a) {
+      // The output buffer may be reused: work on a copy to avoid aliasing.
+      Tensor<n> aux;
+      do_adjoint_into(aux, a);
+      b = aux;
+      return;
+    }
     index rows = a.rows();
     index cols = a.columns();
-    Tensor<n> b(cols, rows);
+    b.resize(igen << cols << rows);
     if (cols && rows) {
       typename Tensor<n>::const_iterator ij_a = a.begin();
       typename Tensor<n>::iterator j_b = b.begin();
@@ -41,6 +48,13 @@ namespace tensor {
         }
       }
     }
+  }
+
+  template<typename n> inline
+  const Tensor<n> do_adjoint(const Tensor<n> &a)
+  {
+    Tensor<n> b;
+    do_adjoint_into(b, a);
     return b;
   }
 
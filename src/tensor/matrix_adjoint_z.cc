@@ -26,4 +26,9 @@ namespace tensor {
     return do_adjoint(a);
   }
 
+  void adjoint_into(CTensor &output, const CTensor &a)
+  {
+    do_adjoint_into(output, a);
+  }
+
 } // namespace tensor
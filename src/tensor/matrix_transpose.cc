@@ -23,14 +23,28 @@
 namespace tensor {
 
   template<typename n> inline
-  const Tensor<n> do_transpose(const Tensor<n> &a)
+  void do_transpose_into(Tensor<n> &b, const Tensor<n> &a)
   {
     assert(a.rank() == 2);
+    if (&b == &a) {
+      // The output buffer may be reused: work on a copy to avoid aliasing.
+      Tensor<n> aux;
+      do_transpose_into(aux, a);
+      b = aux;
+      return;
+    }
     index rows = a.rows();
     index cols = a.columns();
-    Tensor<n> b(cols, rows);
+    b.resize(igen << cols << rows);
     if (cols && rows)
       permute_12(b, a, rows, cols, 1);
+  }
+
+  template<typename n> inline
+  const Tensor<n> do_transpose(const Tensor<n> &a)
+  {
+    Tensor<n> b;
+    do_transpose_into(b, a);
     return b;
   }
 
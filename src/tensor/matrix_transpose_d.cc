@@ -26,4 +26,9 @@ namespace tensor {
     return do_transpose(a);
   }
 
+  void transpose_into(RTensor &output, const RTensor &a)
+  {
+    do_transpose_into(output, a);
+  }
+
 } // namespace tensor
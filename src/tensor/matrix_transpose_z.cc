@@ -26,4 +26,9 @@ namespace tensor {
     return do_transpose(a);
   }
 
+  void transpose_into(CTensor &output, const CTensor &a)
+  {
+    do_transpose_into(output, a);
+  }
+
 } // namespace tensor
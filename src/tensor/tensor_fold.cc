@@ -31,8 +31,16 @@ namespace tensor {
   template<typename elt_t, bool do_conj>
   void
   do_fold(Tensor<elt_t> &output,
-          const Tensor<elt_t> &a, int _ndx1, const Tensor<elt_t> &b, int _ndx2)
+          const Tensor<elt_t> &a, int _ndx1, const Tensor<elt_t> &b, int _ndx2,
+          elt_t alpha = number_one<elt_t>(), elt_t beta = number_zero<elt_t>())
   {
+    if (&output == &a || &output == &b) {
+      // The output buffer may be reused: work on a copy to avoid aliasing.
+      Tensor<elt_t> aux(output);
+      do_fold<elt_t, do_conj>(aux, a, _ndx1, b, _ndx2, alpha, beta);
+      output = aux;
+      return;
+    }
     index i_len,j_len,k_len,l_len,m_len;
     index rank, i;
     const index ranka = a.rank();
@@ -88,19 +96,30 @@ namespace tensor {
       m_len *= di;
     }
     /*
-     * Create the output tensor. Sometimes it is just a number.
+     * Create the output tensor. Sometimes it is just a number. When we
+     * accumulate onto the output (beta != 0) it must already exist and have
+     * the right shape.
      */
     if (rank == 0) {
       rank = 1;
       new_dims.at(0) = 1;
     }
-    output = Tensor<elt_t>(new_dims);
+    const elt_t zero = number_zero<elt_t>();
+    if (beta == zero) {
+      output.resize(new_dims);
+    } else if (!all_equal(output.dimensions(), new_dims)) {
+      std::cerr << "Unable to accumulate fold() of tensors with dimensions"
+                << std::endl
+                << "\t" << a.dimensions() << " and "
+                << b.dimensions() << std::endl
+                << "\tonto a tensor with dimensions "
+                << output.dimensions() << std::endl;
+      abort();
+    }
     if (output.size() == 0)
       return;
 
     elt_t *pC = output.begin();
-    const elt_t zero = number_zero<elt_t>();
-    const elt_t one = number_one<elt_t>();
     const elt_t *pA = a.begin();
     const elt_t *pB = b.begin();
     if (i_len == 1) {
@@ -108,38 +127,38 @@ namespace tensor {
         // C(j_len,m_len) = A(l_len,j_len)*B(l_len,m_len);
         char transa = do_conj? 'C' : 'T';
         char transb = 'N';
-        gemm(transa, transb, j_len, m_len, l_len, one,
-             pA, l_len, pB, l_len, zero, pC, j_len);
+        small_gemm(transa, transb, j_len, m_len, l_len, alpha,
+                   pA, l_len, pB, l_len, beta, pC, j_len);
         return;
       }
       if (m_len == 1) {
         // C(j_len,k_len) = A(l_len,j_len)*B(k_len,l_len);
         char transa = do_conj? 'C' : 'T';
         char transb = 'T';
-        gemm(transa, transb, j_len, k_len, l_len, one,
-             pA, l_len, pB, k_len, zero, pC, j_len);
+        small_gemm(transa, transb, j_len, k_len, l_len, alpha,
+                   pA, l_len, pB, k_len, beta, pC, j_len);
         return;
       }
-    } else if (j_len == 1 && !do_conj) {
+    } else if (j_len == 1) {
       if (k_len == 1) {
         // C(i_len,m_len) = A(i_len,l_len)*B(l_len,m_len);
-        char transa = 'N';
+        char transa = do_conj? 'R' : 'N';
         char transb = 'N';
-        gemm(transa, transb, i_len, m_len, l_len, one,
-             pA, i_len, pB, l_len, zero, pC, i_len);
+        small_gemm(transa, transb, i_len, m_len, l_len, alpha,
+                   pA, i_len, pB, l_len, beta, pC, i_len);
         return;
       }
       if (m_len == 1) {
         // C(i_len,k_len) = A(i_len,l_len)*B(k_len,l_len);
-        char transa = 'N';
+        char transa = do_conj? 'R' : 'N';
         char transb = 'T';
-        gemm(transa, transb, i_len, k_len, l_len, one,
-             pA, i_len, pB, k_len, zero, pC, i_len);
+        small_gemm(transa, transb, i_len, k_len, l_len, alpha,
+                   pA, i_len, pB, k_len, beta, pC, i_len);
         return;
       }
     }
-    const char op1 = 'N';
-    const char op2 = do_conj? 'C' : 'T';
+    const char op1 = do_conj? 'R' : 'N';
+    const char op2 = 'T';
     const index ij_len = i_len*j_len;
     const index il_len = i_len*l_len;
     const index kl_len = k_len*l_len;
@@ -149,15 +168,11 @@ namespace tensor {
      */
     for (index m = 0; m < m_len; m++) {
       for (index j = 0; j < j_len; j++) {
-        gemm(op1, op2, i_len, k_len, l_len, one,
-             pA + il_len*j, i_len, pB + kl_len*m, k_len,
-             zero, pC + i_len*(j + jk_len*m), ij_len);
+        small_gemm(op1, op2, i_len, k_len, l_len, alpha,
+                   pA + il_len*j, i_len, pB + kl_len*m, k_len,
+                   beta, pC + i_len*(j + jk_len*m), ij_len);
       }
     }
-    if (do_conj) {
-      for (index i = output.size(); i; i--, pC++)
-        *pC = tensor::conj(*pC);
-    }
   }
 
 } // namespace tensor
@@ -63,6 +63,29 @@ namespace tensor {
     do_fold<double, false>(c, a, ndx1, b, ndx2);
   }
 
+  /**Accumulating contraction. \c fold_acc(C,alpha,A,n,B,m,beta) computes
+     \c C=alpha*fold(A,n,B,m)+beta*C without allocating a new tensor. When
+     \c beta is nonzero, \c C must already have the dimensions of the result.
+
+     \ingroup Tensors
+  */
+  void fold_acc(Tensor<double> &c, double alpha, const Tensor<double> &a, int ndx1,
+                const Tensor<double> &b, int ndx2, double beta)
+  {
+    do_fold<double, false>(c, a, ndx1, b, ndx2, alpha, beta);
+  }
+
+  /**Accumulating contraction with conjugation, \c C=alpha*foldc(A,n,B,m)+beta*C.
+     \see fold_acc()
+
+     \ingroup Tensors
+  */
+  void foldc_acc(Tensor<double> &c, double alpha, const Tensor<double> &a, int ndx1,
+                 const Tensor<double> &b, int ndx2, double beta)
+  {
+    do_fold<double, false>(c, a, ndx1, b, ndx2, alpha, beta);
+  }
+
   /**Matrix multiplication. \c mmult(A,B) is equivalent to \c fold(A,-1,B,0). */
 
   const Tensor<double> mmult(const Tensor<double> &m1, const Tensor<double> &m2)
@@ -75,4 +98,15 @@ namespace tensor {
     fold_into(c, m1, -1, m2, 0);
   }
 
+  /**Accumulating matrix multiplication, \c C=alpha*mmult(A,B)+beta*C.
+     \see fold_acc()
+
+     \ingroup Tensors
+  */
+  void mmult_acc(Tensor<double> &c, double alpha, const Tensor<double> &m1,
+                 const Tensor<double> &m2, double beta)
+  {
+    fold_acc(c, alpha, m1, -1, m2, 0, beta);
+  }
+
 } // namespace tensor
@@ -17,42 +17,155 @@
     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 */
 
+#include <iostream>
 #include <tensor/tensor.h>
+#include <tensor/io.h>
+#include <tensor/detail/common.h>
+#include "gemm.cc"
 
 namespace tensor {
 
+  using namespace blas;
+
+  /* Dimensions of fold(a, ndx1, b, ndx2) */
+  template<class t1, class t2>
+  static const Indices fold_dimensions(const t1 &a, int ndx1, const t2 &b, int ndx2)
+  {
+    Indices dims(std::max<index>(a.rank() + b.rank() - 2, 1));
+    index rank = 0;
+    dims.at(0) = 1;
+    for (index i = 0; i < a.rank(); i++)
+      if (i != ndx1) dims.at(rank++) = a.dimension(i);
+    for (index i = 0; i < b.rank(); i++)
+      if (i != ndx2) dims.at(rank++) = b.dimension(i);
+    return dims;
+  }
+
+  /* C = A * op2(B), where A and C are I x l_len and I x n real views of
+     complex matrices, with the real and imaginary parts of each complex
+     element in consecutive rows. When 'conjugate' is true, A is conjugated
+     by flipping the sign of its imaginary rows: with I == 2 this is done by
+     gemm itself, otherwise on each tile of C right after it is computed. */
+  static void fold_zd_gemm(char op2, index I, index n, index l_len,
+                           const double *pA, index lda, const double *pB,
+                           index ldb, double *pC, index ldc, bool conjugate)
+  {
+    if (!conjugate) {
+      small_gemm('N', op2, I, n, l_len, 1.0, pA, lda, pB, ldb, 0.0, pC, ldc);
+    } else if (I == 2) {
+      small_gemm('N', op2, 1, n, l_len, 1.0, pA, lda, pB, ldb, 0.0, pC, ldc);
+      small_gemm('N', op2, 1, n, l_len, -1.0, pA + 1, lda, pB, ldb, 0.0,
+                 pC + 1, ldc);
+    } else {
+      small_gemm('N', op2, I, n, l_len, 1.0, pA, lda, pB, ldb, 0.0, pC, ldc);
+      for (index c = 0; c < n; c++, pC += ldc)
+        for (index r = 1; r < I; r += 2)
+          pC[r] = -pC[r];
+    }
+  }
+
+  /* C(i,j,k,m) = A(i,l,j) B(k,l,m) with A complex and B real. Since the real
+     and imaginary parts of A are interleaved, A can be seen as a real tensor
+     A'(2,i,l,j) and the real product A'(2,i,l,j) B(k,l,m) produces C in
+     the same interleaved format. */
+  static const CTensor fold_zd(const CTensor &a, int ndx1, const RTensor &b,
+                               int ndx2, bool conjugate)
+  {
+    ndx1 = normalize_index(ndx1, a.rank());
+    ndx2 = normalize_index(ndx2, b.rank());
+    index i_len = 1, j_len = 1, k_len = 1, m_len = 1;
+    for (index i = 0; i < ndx1; i++)
+      i_len *= a.dimension(i);
+    for (index i = ndx1 + 1; i < a.rank(); i++)
+      j_len *= a.dimension(i);
+    for (index i = 0; i < ndx2; i++)
+      k_len *= b.dimension(i);
+    for (index i = ndx2 + 1; i < b.rank(); i++)
+      m_len *= b.dimension(i);
+    index l_len = a.dimension(ndx1);
+    if (l_len == 0 || l_len != b.dimension(ndx2)) {
+      std::cerr << "Unable to fold() tensors with dimensions" << std::endl
+                << "\t" << a.dimensions() << " and "
+                << b.dimensions() << std::endl
+                << "\tbecause indices " << ndx1 << " and " << ndx2
+                << (l_len? " have different sizes" : " are empty") << std::endl;
+      abort();
+    }
+    CTensor output(fold_dimensions(a, ndx1, b, ndx2));
+    if (output.size() == 0)
+      return output;
+
+    const index I = 2 * i_len;
+    double *pC = reinterpret_cast<double *>(output.begin());
+    const double *pA = reinterpret_cast<const double *>(a.begin());
+    const double *pB = b.begin();
+    if (j_len == 1 && k_len == 1) {
+      // C'(I,m_len) = A'(I,l_len) * B(l_len,m_len)
+      fold_zd_gemm('N', I, m_len, l_len, pA, I, pB, l_len, pC, I, conjugate);
+      return output;
+    }
+    // C'(I,j,k,m) = A'(I,l,j) * B(k,l,m)
+    const index Il_len = I * l_len;
+    const index kl_len = k_len * l_len;
+    const index Ij_len = I * j_len;
+    for (index m = 0; m < m_len; m++) {
+      for (index j = 0; j < j_len; j++) {
+        fold_zd_gemm('T', I, k_len, l_len, pA + Il_len * j, I,
+                     pB + kl_len * m, k_len,
+                     pC + I * j + Ij_len * k_len * m, Ij_len, conjugate);
+      }
+    }
+    return output;
+  }
+
+  /* The real-complex product is computed as a complex-real one, with the
+     indices in the wrong order, which are then transposed as a matrix. */
+  static const CTensor fold_dz(const RTensor &a, int ndx1, const CTensor &b, int ndx2)
+  {
+    ndx1 = normalize_index(ndx1, a.rank());
+    ndx2 = normalize_index(ndx2, b.rank());
+    CTensor ba = fold_zd(b, ndx2, a, ndx1, false);
+    index a_len = a.size() / a.dimension(ndx1);
+    index b_len = b.size() / b.dimension(ndx2);
+    Indices dims = fold_dimensions(a, ndx1, b, ndx2);
+    if (a_len == 1 || b_len == 1) {
+      return reshape(ba, dims);
+    }
+    return reshape(transpose(reshape(ba, b_len, a_len)), dims);
+  }
+
   const Tensor<cdouble> fold(const Tensor<double> &a, int ndx1,
                              const Tensor<cdouble> &b, int ndx2)
   {
-    return fold(to_complex(a), ndx1, b, ndx2);
+    return fold_dz(a, ndx1, b, ndx2);
   }
 
   const Tensor<cdouble> foldc(const Tensor<double> &a, int ndx1,
                               const Tensor<cdouble> &b, int ndx2)
   {
-    return fold(to_complex(a), ndx1, b, ndx2);
+    return fold_dz(a, ndx1, b, ndx2);
   }
 
   const Tensor<cdouble> mmult(const Tensor<double> &m1, const Tensor<cdouble> &m2)
   {
-    return fold(to_complex(m1), -1, m2, 0);
+    return fold_dz(m1, -1, m2, 0);
   }
 
   const Tensor<cdouble> fold(const Tensor<cdouble> &a, int ndx1,
                              const Tensor<double> &b, int ndx2)
   {
-    return fold(a, ndx1, to_complex(b), ndx2);
+    return fold_zd(a, ndx1, b, ndx2, false);
   }
 
   const Tensor<cdouble> foldc(const Tensor<cdouble> &a, int ndx1,
                               const Tensor<double> &b, int ndx2)
   {
-    return foldc(a, ndx1, to_complex(b), ndx2);
+    return fold_zd(a, ndx1, b, ndx2, true);
   }
 
   const Tensor<cdouble> mmult(const Tensor<cdouble> &m1, const Tensor<double> &m2)
   {
-    return fold(m1, -1, to_complex(m2), 0);
+    return fold_zd(m1, -1, m2, 0, false);
   }
 
 } // namespace tensor
@@ -73,6 +73,29 @@ namespace tensor {
     do_fold<cdouble, false>(c, a, ndx1, b, ndx2);
   }
 
+  /**Accumulating contraction. \c fold_acc(C,alpha,A,n,B,m,beta) computes
+     \c C=alpha*fold(A,n,B,m)+beta*C without allocating a new tensor. When
+     \c beta is nonzero, \c C must already have the dimensions of the result.
+
+     \ingroup Tensors
+  */
+  void fold_acc(Tensor<cdouble> &c, cdouble alpha, const Tensor<cdouble> &a, int ndx1,
+                const Tensor<cdouble> &b, int ndx2, cdouble beta)
+  {
+    do_fold<cdouble, false>(c, a, ndx1, b, ndx2, alpha, beta);
+  }
+
+  /**Accumulating contraction with conjugation, \c C=alpha*foldc(A,n,B,m)+beta*C.
+     \see fold_acc()
+
+     \ingroup Tensors
+  */
+  void foldc_acc(Tensor<cdouble> &c, cdouble alpha, const Tensor<cdouble> &a, int ndx1,
+                 const Tensor<cdouble> &b, int ndx2, cdouble beta)
+  {
+    do_fold<cdouble, true>(c, a, ndx1, b, ndx2, alpha, beta);
+  }
+
   /**Matrix multiplication. \c mmult(A,B) is equivalent to \c fold(A,-1,B,0). */
   const Tensor<cdouble> mmult(const Tensor<cdouble> &m1, const Tensor<cdouble> &m2)
   {
@@ -84,4 +107,15 @@ namespace tensor {
     fold_into(c, m1, -1, m2, 0);
   }
 
+  /**Accumulating matrix multiplication, \c C=alpha*mmult(A,B)+beta*C.
+     \see fold_acc()
+
+     \ingroup Tensors
+  */
+  void mmult_acc(Tensor<cdouble> &c, cdouble alpha, const Tensor<cdouble> &m1,
+                 const Tensor<cdouble> &m2, cdouble beta)
+  {
+    fold_acc(c, alpha, m1, -1, m2, 0, beta);
+  }
+
 } // namespace tensor
@@ -31,8 +31,17 @@ namespace tensor {
   template<typename elt_t>
   void
   do_foldin_into(Tensor<elt_t> &output,
-                 const Tensor<elt_t> &a, int _ndx1, const Tensor<elt_t> &b, int _ndx2)
+                 const Tensor<elt_t> &a, int _ndx1, const Tensor<elt_t> &b, int _ndx2,
+                 elt_t alpha = number_one<elt_t>(),
+                 elt_t beta = number_zero<elt_t>())
   {
+    if (&output == &a || &output == &b) {
+      // The output buffer may be reused: work on a copy to avoid aliasing.
+      Tensor<elt_t> aux(output);
+      do_foldin_into(aux, a, _ndx1, b, _ndx2, alpha, beta);
+      output = aux;
+      return;
+    }
     index i_len,j_len,k_len,l_len,m_len;
     index rank, i;
     const index ranka = a.rank();
@@ -86,13 +95,21 @@ namespace tensor {
       rank = 1;
       new_dims.at(0) = 1;
     }
-    output = Tensor<elt_t>(new_dims);
+    if (beta == number_zero<elt_t>()) {
+      output.resize(new_dims);
+    } else if (!all_equal(output.dimensions(), new_dims)) {
+      std::cerr << "Unable to accumulate foldin() of tensors with dimensions"
+                << std::endl
+                << "\t" << a.dimensions() << " and "
+                << b.dimensions() << std::endl
+                << "\tonto a tensor with dimensions "
+                << output.dimensions() << std::endl;
+      abort();
+    }
     if (output.size() == 0)
       return;
 
     elt_t *pC = output.begin();
-    elt_t zero = number_zero<elt_t>();
-    elt_t one = number_one<elt_t>();
     const elt_t *pA = a.begin();
     const elt_t *pB = b.begin();
     char op1 = 'N';
@@ -102,9 +119,9 @@ namespace tensor {
     index ki_len = k_len*i_len;
     for (index m = 0; m < m_len; m++) {
       for (index j = 0; j < j_len; j++) {
-        gemm(op1, op2, k_len, i_len, l_len, one,
-             pB + kl_len*m, k_len, pA + il_len*j, i_len,
-             zero, pC + ki_len*(j + j_len*m), k_len);
+        small_gemm(op1, op2, k_len, i_len, l_len, alpha,
+                   pB + kl_len*m, k_len, pA + il_len*j, i_len,
+                   beta, pC + ki_len*(j + j_len*m), k_len);
       }
     }
   }
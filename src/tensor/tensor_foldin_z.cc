@@ -50,4 +50,16 @@ namespace tensor {
     do_foldin_into(output, a, _ndx1, b, _ndx2);
   }
 
+  /**Similar to foldin(), but accumulating onto the output as in
+     \c C=alpha*foldin(A,n,B,m)+beta*C. \see fold_acc()
+
+     \ingroup Tensors
+  */
+  void
+  foldin_acc(Tensor<cdouble> &output, cdouble alpha, const Tensor<cdouble> &a, int _ndx1,
+             const Tensor<cdouble> &b, int _ndx2, cdouble beta)
+  {
+    do_foldin_into(output, a, _ndx1, b, _ndx2, alpha, beta);
+  }
+
 } // namespace tensor
@@ -31,51 +31,84 @@ namespace tensor {
   // KRONECKER PRODUCT OF TENSORS
   //
 
+#ifndef TENSOR_KRON_PARALLEL_SIZE
+#define TENSOR_KRON_PARALLEL_SIZE 65536
+#endif
+
+  /* pc[i] = v * pa[i], written so that the compiler can vectorize it. */
+  static inline void
+  kron_scale(double *pc, const double *pa, double v, index n)
+  {
+    for (index i = 0; i < n; i++)
+      pc[i] = v * pa[i];
+  }
+
+  static inline void
+  kron_scale(cdouble *pc, const cdouble *pa, cdouble v, index n)
+  {
+    // Real arithmetic avoids the NaN checks of the complex product.
+    double *c = reinterpret_cast<double *>(pc);
+    const double *a = reinterpret_cast<const double *>(pa);
+    const double vr = std::real(v), vi = std::imag(v);
+    for (index i = 0; i < 2*n; i += 2) {
+      c[i] = vr * a[i] - vi * a[i+1];
+      c[i+1] = vr * a[i+1] + vi * a[i];
+    }
+  }
+
   template<typename elt_t>
   static inline
-  const Tensor<elt_t> do_kron(const Tensor<elt_t> &b, const Tensor<elt_t> &a)
+  void do_kron_into(Tensor<elt_t> &output,
+                    const Tensor<elt_t> &b, const Tensor<elt_t> &a)
   {
     assert(b.rank() == a.rank());
     assert(b.rank() <= 2);
-    if (a.rank() == 1) {
-      // FIXME! CHAPUZA!
-      return reshape(kron(reshape(b, b.size(), 1),
-                          reshape(a, a.size(), 1)),
-                     a.size() * b.size());
+    if (&output == &a || &output == &b) {
+      // The output buffer may be reused: work on a copy to avoid aliasing.
+      Tensor<elt_t> aux;
+      do_kron_into(aux, b, a);
+      output = aux;
+      return;
     }
 
     // C([i,j],[k,l]) = A(i,k) B(j,l)
-    const index i_len = a.rows();
-    const index j_len = b.rows();
-    const index k_len = a.columns();
-    const index l_len = b.columns();
+    // Vectors are treated as matrices with one column.
+    const index i_len = a.dimension(0);
+    const index j_len = b.dimension(0);
+    const index k_len = (a.rank() == 1)? 1 : a.columns();
+    const index l_len = (b.rank() == 1)? 1 : b.columns();
     const index ij_len = i_len*j_len;
     const index kl_len = k_len*l_len;
+    if (a.rank() == 1)
+      output.resize(igen << ij_len);
+    else
+      output.resize(igen << ij_len << kl_len);
     if (ij_len == 0 || kl_len == 0)
-      return Tensor<elt_t>(ij_len, kl_len);
+      return;
 
-    Tensor<elt_t> output(ij_len, k_len*l_len);
-    typename Tensor<elt_t>::iterator pc = output.begin();
-    typename Tensor<elt_t>::const_iterator pb = b.begin();
-    for (index l = 0; l < l_len; l++, pb += j_len) {
-      typename Tensor<elt_t>::const_iterator pa = a.begin();
-      for (index k = 0; k < k_len; k++, pa += i_len) {
-#ifdef MPS_USE_CBLAS
-        memset(pc, 0, ij_len * sizeof(*pc));
-        geru(i_len, j_len, Tensor<elt_t>::elt_one(), pa, 1, pb, 1, pc, i_len);
-        pc += i_len*j_len;
-#else
-        typename Tensor<elt_t>::const_iterator pb2 = pb;
-        for (index j = 0; j < j_len; j++, pb2++) {
-          typename Tensor<elt_t>::const_iterator pa2 = pa;
-          const elt_t v = *pb2;
-          for (index i = 0; i < i_len; i++, pc++, pa2++) {
-            *pc = v * (*pa2);
-          }
-        }
-#endif
+    // Each column [k,l] of C is built from the columns A(:,k) and B(:,l),
+    // which stay in cache, and is written sequentially. Columns are
+    // independent and large products split them among threads.
+    elt_t *pc = output.begin();
+    const elt_t *pa = a.begin();
+    const elt_t *pb = b.begin();
+#pragma omp parallel for if (ij_len * kl_len > TENSOR_KRON_PARALLEL_SIZE)
+    for (index kl = 0; kl < kl_len; kl++) {
+      const elt_t *pak = pa + i_len * (kl % k_len);
+      const elt_t *pbl = pb + j_len * (kl / k_len);
+      elt_t *pckl = pc + ij_len * kl;
+      for (index j = 0; j < j_len; j++) {
+        kron_scale(pckl + i_len * j, pak, pbl[j], i_len);
       }
     }
+  }
+
+  template<typename elt_t>
+  static inline
+  const Tensor<elt_t> do_kron(const Tensor<elt_t> &b, const Tensor<elt_t> &a)
+  {
+    Tensor<elt_t> output;
+    do_kron_into(output, b, a);
     return output;
   }
 
@@ -84,20 +117,46 @@ namespace tensor {
   {
     assert(a.rank() == b.rank());
     assert(a.rank() <= 2);
+    // C = kron(eye(b1,b2), a) + kron(b, eye(a1,a2)), built in one pass:
+    // C([i,j],[k,l]) = A(i,k) delta(j,l) + delta(i,k) B(j,l)
+    // Vectors are sums V([i,j]) = A(i) + B(j).
+    const index i_len = a.dimension(0);
+    const index j_len = b.dimension(0);
     if (a.rank() == 1) {
-      // FIXME! CHAPUZA!
-      index a1 = a.size();
-      index b1 = b.size();
-      return reshape(kron2(reshape(a, a1,1), Tensor<elt_t>::ones(b1,1)) +
-                     kron2(Tensor<elt_t>::ones(a1,1), reshape(b, b1,1)),
-                     a1*b1);
-    } else {
-      index a1,a2,b1,b2;
-      a.get_dimensions(&a1, &a2);
-      b.get_dimensions(&b1, &b2);
-      return kron(Tensor<elt_t>::eye(b1,b2), a) +
-        kron(b, Tensor<elt_t>::eye(a1,a2));
+      Tensor<elt_t> output(i_len * j_len);
+      typename Tensor<elt_t>::iterator pc = output.begin();
+      typename Tensor<elt_t>::const_iterator pb = b.begin();
+      for (index j = 0; j < j_len; j++, pb++) {
+        typename Tensor<elt_t>::const_iterator pa = a.begin();
+        for (index i = 0; i < i_len; i++, pc++, pa++) {
+          *pc = *pa + *pb;
+        }
+      }
+      return output;
     }
+    const index k_len = a.columns();
+    const index l_len = b.columns();
+    const index ij_len = i_len * j_len;
+    Tensor<elt_t> output = Tensor<elt_t>::zeros(ij_len, k_len * l_len);
+    typename Tensor<elt_t>::iterator pc = output.begin();
+    for (index l = 0; l < l_len; l++) {
+      typename Tensor<elt_t>::const_iterator pa = a.begin();
+      for (index k = 0; k < k_len; k++, pc += ij_len, pa += i_len) {
+        if (l < j_len) {
+          // A(:,k) delta(j,l)
+          typename Tensor<elt_t>::iterator pcl = pc + i_len * l;
+          for (index i = 0; i < i_len; i++)
+            pcl[i] += pa[i];
+        }
+        if (k < i_len) {
+          // delta(i,k) B(:,l)
+          typename Tensor<elt_t>::const_iterator pb = b.begin() + j_len * l;
+          for (index j = 0; j < j_len; j++)
+            pc[k + i_len * j] += pb[j];
+        }
+      }
+    }
+    return output;
   }
 
 } // namespace tensor
@@ -48,4 +48,16 @@ namespace tensor {
     return do_kron(s2, s1);
   }
 
+  void kron_into(Tensor<double> &output, const Tensor<double> &s1,
+                 const Tensor<double> &s2)
+  {
+    do_kron_into(output, s1, s2);
+  }
+
+  void kron2_into(Tensor<double> &output, const Tensor<double> &s1,
+                  const Tensor<double> &s2)
+  {
+    do_kron_into(output, s2, s1);
+  }
+
 } // namespace tensor
@@ -48,4 +48,16 @@ namespace tensor {
     return do_kron(s2, s1);
   }
 
+  void kron_into(Tensor<cdouble> &output, const Tensor<cdouble> &s1,
+                 const Tensor<cdouble> &s2)
+  {
+    do_kron_into(output, s1, s2);
+  }
+
+  void kron2_into(Tensor<cdouble> &output, const Tensor<cdouble> &s1,
+                  const Tensor<cdouble> &s2)
+  {
+    do_kron_into(output, s2, s1);
+  }
+
 } // namespace tensor
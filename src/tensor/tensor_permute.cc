@@ -139,14 +139,23 @@ namespace tensor {
   }
 
   template<typename n>
-  const Tensor<n> do_permute(const Tensor<n> &a, index ndx1, index ndx2)
+  void do_permute_into(Tensor<n> &output, const Tensor<n> &a,
+                       index ndx1, index ndx2)
   {
+    if (&output == &a) {
+      // The output buffer may be reused: work on a copy to avoid aliasing.
+      Tensor<n> aux;
+      do_permute_into(aux, a, ndx1, ndx2);
+      output = aux;
+      return;
+    }
     index n1 = normalize_index(ndx1, a.rank());
     index n2 = normalize_index(ndx2, a.rank());
     if (n2 < n1) {
       std::swap(n1,n2);
     } else if (n2 == n1) {
-      return a;
+      output = a;
+      return;
     }
     Indices new_dims = a.dimensions();
     index i,a1,a2,a3,a4,a5;
@@ -170,27 +179,35 @@ namespace tensor {
         goto NO_A3;
       }
       if (a3 > 1) {
-        Tensor<n> output(new_dims);
+        output.resize(new_dims);
         if (a1 > 1) {
           permute_24(output, a, a1,a2,a3,a4,a5);
         } else {
           permute_13(output, a, a2,a3,a4,a5);
         }
-        return output;
+        return;
       } else {
       NO_A3:
         if (a4 > 1 || a2 > 1) {
-          Tensor<n> output(new_dims);
+          output.resize(new_dims);
           if (a1 > 1) {
             permute_23(output, a, a1,a2,a4,a5);
           } else {
             permute_12(output, a, a2,a4,a5);
           }
-          return output;
+          return;
         }
       }
     }
-    return reshape(a, new_dims);
+    output = reshape(a, new_dims);
+  }
+
+  template<typename n>
+  const Tensor<n> do_permute(const Tensor<n> &a, index ndx1, index ndx2)
+  {
+    Tensor<n> output;
+    do_permute_into(output, a, ndx1, ndx2);
+    return output;
   }
 
 } // namespace tensor
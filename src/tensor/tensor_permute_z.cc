@@ -26,4 +26,9 @@ namespace tensor {
     return do_permute(a, i1, i2);
   }
 
+  void permute_into(CTensor &output, const CTensor &a, index i1, index i2)
+  {
+    do_permute_into(output, a, i1, i2);
+  }
+
 } // namespace tensor
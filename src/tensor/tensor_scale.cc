@@ -91,4 +91,30 @@ void doscale(t1 *p1, const t2 *p2, const t3 *p30,
     }
 }
 
+template<typename t1, typename t2>
+void do_scale_into(Tensor<t1> &output, const Tensor<t1> &t, int ndx,
+                   const Tensor<t2> &v)
+{
+    if ((void*)&output == (void*)&v) {
+      // The output buffer may be reused: work on a copy to avoid aliasing.
+      Tensor<t1> aux;
+      do_scale_into(aux, t, ndx, v);
+      output = aux;
+      return;
+    }
+    index d1, d2, d3;
+    ndx = normalize_index(ndx, t.rank());
+    surrounding_dimensions(t.dimensions(), ndx, &d1, &d2, &d3);
+    if (d2 != v.size()) {
+      std::cerr << "In scale() the dimension " << ndx <<
+	" of the tensor does not match the length " <<
+	v.size() << " of the scale vector" << std::endl;
+      abort();
+    }
+    // Element-wise operation: output may share the buffer of t.
+    if (&output != &t)
+      output.resize(t.dimensions());
+    doscale(output.begin(), t.begin_const(), v.begin_const(), d1, d2, d3);
+}
+
 } // namespace tensor
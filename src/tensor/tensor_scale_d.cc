@@ -31,20 +31,21 @@ namespace tensor {
   const Tensor<double> scale(const Tensor<double> &t, int ndx,
 			     const Tensor<double> &v)
   {
-    index d1, d2, d3;
-    Tensor<double> output(t.dimensions());
-    ndx = normalize_index(ndx, t.rank());
-    surrounding_dimensions(t.dimensions(), ndx, &d1, &d2, &d3);
-    if (d2 != v.size()) {
-      std::cerr << "In scale() the dimension " << ndx <<
-	" of the tensor does not match the length " <<
-	v.size() << " of the scale vector" << std::endl;
-      abort();
-    }
-    doscale(output.begin(), t.begin_const(), v.begin_const(), d1, d2, d3);
+    Tensor<double> output;
+    scale_into(output, t, ndx, v);
     return output;
   }
 
+  /**Similar to scale(), but reusing the storage of \c output when possible.
+
+     \ingroup Tensors
+  */
+  void scale_into(Tensor<double> &output, const Tensor<double> &t, int ndx,
+                  const Tensor<double> &v)
+  {
+    do_scale_into(output, t, ndx, v);
+  }
+
   void scale_inplace(Tensor<double> &t, int ndx, const Tensor<double> &v)
   {
     index d1, d2, d3;
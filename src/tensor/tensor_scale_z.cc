@@ -31,20 +31,21 @@ namespace tensor {
   const Tensor<cdouble> scale(const Tensor<cdouble> &t, int ndx,
 			      const Tensor<cdouble> &v)
   {
-    index d1, d2, d3;
-    Tensor<cdouble> output(t.dimensions());
-    ndx = normalize_index(ndx, t.rank());
-    surrounding_dimensions(t.dimensions(), ndx, &d1, &d2, &d3);
-    if (d2 != v.size()) {
-      std::cerr << "In scale() the dimension " << ndx <<
-	" of the tensor does not match the length " <<
-	v.size() << " of the scale vector" << std::endl;
-      abort();
-    }
-    doscale(output.begin(), t.begin_const(), v.begin_const(), d1, d2, d3);
+    Tensor<cdouble> output;
+    scale_into(output, t, ndx, v);
     return output;
   }
 
+  /**Similar to scale(), but reusing the storage of \c output when possible.
+
+     \ingroup Tensors
+  */
+  void scale_into(Tensor<cdouble> &output, const Tensor<cdouble> &t, int ndx,
+                  const Tensor<cdouble> &v)
+  {
+    do_scale_into(output, t, ndx, v);
+  }
+
   void scale_inplace(Tensor<cdouble> &t, int ndx, const Tensor<cdouble> &v)
   {
     index d1, d2, d3;
@@ -62,12 +63,29 @@ namespace tensor {
   const Tensor<cdouble> scale(const Tensor<cdouble> &t, int ndx,
 			      const Tensor<double> &v)
   {
-    return scale(t, ndx, to_complex(v));
+    Tensor<cdouble> output;
+    scale_into(output, t, ndx, v);
+    return output;
+  }
+
+  void scale_into(Tensor<cdouble> &output, const Tensor<cdouble> &t, int ndx,
+                  const Tensor<double> &v)
+  {
+    do_scale_into(output, t, ndx, v);
   }
 
   void scale_inplace(Tensor<cdouble> &t, int ndx, const Tensor<double> &v)
   {
-    scale_inplace(t, ndx, to_complex(v));
+    index d1, d2, d3;
+    surrounding_dimensions(t.dimensions(), normalize_index(ndx, t.rank()),
+                           &d1, &d2, &d3);
+    if (d2 != v.size()) {
+      std::cerr << "In scale() the dimension " << ndx <<
+	" of the tensor does not match the length " <<
+	v.size() << " of the scale vector" << std::endl;
+      abort();
+    }
+    doscale(t.begin(), v.begin_const(), d1, d2, d3);
   }
 
 } // namespace tensor
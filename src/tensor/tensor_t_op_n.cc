@@ -21,23 +21,35 @@
 
 namespace tensor {
 
-  const TYPE3 OPERATOR1(const TYPE1 &a, TYPE2 b) {
-    TYPE3 output(a.dimensions());
+  void OPNAME_into(TYPE3 &output, const TYPE1 &a, TYPE2 b) {
+    if ((void*)&output != (void*)&a)
+      output.resize(a.dimensions());
     TYPE1::const_iterator ita = a.begin();
     TYPE3::iterator dest = output.begin();
     for (index i = a.size(); i; --i, ++dest, ++ita) {
       *dest = (*ita) OPERATOR2 (b);
     }
-    return output;
   }
 
-  const TYPE3 OPERATOR1(TYPE2 a, const TYPE1 &b) {
-    TYPE3 output(b.dimensions());
+  void OPNAME_into(TYPE3 &output, TYPE2 a, const TYPE1 &b) {
+    if ((void*)&output != (void*)&b)
+      output.resize(b.dimensions());
     TYPE1::const_iterator itb = b.begin();
     TYPE3::iterator dest = output.begin();
     for (index i = b.size(); i; --i, ++dest, ++itb) {
       *dest = (a) OPERATOR2 (*itb);
     }
+  }
+
+  const TYPE3 OPERATOR1(const TYPE1 &a, TYPE2 b) {
+    TYPE3 output;
+    OPNAME_into(output, a, b);
+    return output;
+  }
+
+  const TYPE3 OPERATOR1(TYPE2 a, const TYPE1 &b) {
+    TYPE3 output;
+    OPNAME_into(output, a, b);
     return output;
   }
 
@@ -21,15 +21,23 @@
 
 namespace tensor {
 
-  const TYPE3 OPERATOR1(const TYPE1 &a, const TYPE2 &b) {
+  void OPNAME_into(TYPE3 &output, const TYPE1 &a, const TYPE2 &b) {
     assert(a.size() == b.size());
-    TYPE3 output(a.dimensions());
+    if ((void*)&output == (void*)&b)
+      output.reshape(a.dimensions());
+    else if ((void*)&output != (void*)&a)
+      output.resize(a.dimensions());
     TYPE1::const_iterator ita = a.begin();
     TYPE2::const_iterator itb = b.begin();
     TYPE3::iterator dest = output.begin();
     for (index i = a.size(); i; --i, ++dest, ++ita, ++itb) {
       *dest = (*ita) OPERATOR2 (*itb);
     }
+  }
+
+  const TYPE3 OPERATOR1(const TYPE1 &a, const TYPE2 &b) {
+    TYPE3 output;
+    OPNAME_into(output, a, b);
     return output;
   }
 
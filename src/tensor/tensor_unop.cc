@@ -22,13 +22,20 @@
 
 namespace tensor {
 
-  TYPE2 OPERATOR1(const TYPE1 &t) {
-    TYPE2 output(t.dimensions());
-    TYPE1::const_iterator src = t.begin();
+  void OPNAME_into(TYPE2 &output, const TYPE1 &t) {
+    if ((void*)&output != (void*)&t)
+      output.resize(t.dimensions());
+    // 'dest' first: it unshares the buffer when 'output' aliases 't'
     TYPE2::iterator dest = output.begin();
-    for (; src != t.end(); src++, dest++) {
+    TYPE1::const_iterator src = t.begin();
+    for (index i = t.size(); i; --i, ++src, ++dest) {
       *dest = OPERATOR2(*src);
     }
+  }
+
+  TYPE2 OPERATOR1(const TYPE1 &t) {
+    TYPE2 output;
+    OPNAME_into(output, t);
     return output;
   }
 
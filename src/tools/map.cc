@@ -18,20 +18,89 @@
 */
 
 #include <tensor/map.h>
+#include <tensor/io.h>
 
 namespace tensor {
 
-  template<class Matrix>
-  MatrixMap<Matrix>::MatrixMap(const Matrix &m, bool transpose)
+  template<class Matrix, class tensor_type>
+  MatrixMap<Matrix,tensor_type>::MatrixMap(const Matrix &m, bool transpose)
     : m_(m), transpose_(transpose)
   {}
 
+  template<class Matrix, class tensor_type>
+  MatrixMap<Matrix,tensor_type>::~MatrixMap() {}
+
+  template<class Matrix, class tensor_type>
+  const typename MatrixMap<Matrix,tensor_type>::tensor_t
+  MatrixMap<Matrix,tensor_type>::operator()(const tensor_t &arg) const
+  { return transpose_? mmult(arg, m_) : mmult(m_, arg); }
+
   template<class Matrix>
-  MatrixMap<Matrix>::~MatrixMap() {}
+  KronMap<Matrix>::KronMap(const Matrix &A, const Matrix &B)
+    : At_(1, transpose(A)), B_(1, B),
+      a_rows_(A.rows()), a_cols_(A.columns()),
+      b_rows_(B.rows()), b_cols_(B.columns())
+  {}
 
   template<class Matrix>
-  const typename MatrixMap<Matrix>::tensor_t
-  MatrixMap<Matrix>::operator()(const tensor_t &arg) const
-  { return transpose_? mmult(arg, m_) : mmult(m_, arg); }
+  KronMap<Matrix>::~KronMap() {}
+
+  template<class Matrix>
+  void KronMap<Matrix>::add(const Matrix &A, const Matrix &B)
+  {
+    if (A.rows() != a_rows_ || A.columns() != a_cols_ ||
+        B.rows() != b_rows_ || B.columns() != b_cols_) {
+      std::cerr << "In KronMap::add(), the new term has factors with dimensions "
+                << A.dimensions() << " and " << B.dimensions() << std::endl
+                << "but the map was created with factors of dimensions "
+                << "(" << a_rows_ << "," << a_cols_ << ") and ("
+                << b_rows_ << "," << b_cols_ << ")" << std::endl;
+      abort();
+    }
+    At_.push_back(transpose(A));
+    B_.push_back(B);
+  }
+
+  template<class Matrix>
+  const typename KronMap<Matrix>::tensor_t
+  KronMap<Matrix>::operator()(const tensor_t &arg) const
+  {
+    if (arg.rank() == 1 && arg.size() == columns())
+      return apply_vector(arg);
+    if (arg.rank() != 2 || arg.rows() != columns()) {
+      std::cerr << "In KronMap, cannot apply an operator with " << columns()
+                << " columns to a tensor with dimensions "
+                << arg.dimensions() << std::endl;
+      abort();
+    }
+    tensor_t output(rows(), arg.columns());
+    for (index c = 0; c < arg.columns(); c++) {
+      output.at(range(), range(c)) = apply_vector(arg(range(), range(c)));
+    }
+    return output;
+  }
+
+  template<class Matrix>
+  const typename KronMap<Matrix>::tensor_t
+  KronMap<Matrix>::apply_vector(const tensor_t &x) const
+  {
+    // kron(A,B) x = vec(B X A^T), with X = reshape(x, B.columns(), A.columns())
+    // We choose the order of the products that has the smallest cost.
+    const tensor_t X = reshape(x, b_cols_, a_cols_);
+    const bool b_first =
+      b_rows_ * a_cols_ * (b_cols_ + a_rows_) <=
+      a_rows_ * b_cols_ * (a_cols_ + b_rows_);
+    tensor_t output;
+    for (size_t n = 0; n < B_.size(); n++) {
+      tensor_t Y = b_first?
+        mmult(mmult(B_[n], X), At_[n]) :
+        mmult(B_[n], mmult(X, At_[n]));
+      if (n)
+        output += Y;
+      else
+        output = Y;
+    }
+    return reshape(output, rows());
+  }
 
 } // namespace tensor
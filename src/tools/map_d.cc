@@ -23,5 +23,6 @@ namespace tensor {
 
   // Explicitely instantiate an specialization of MatrixMap
   template class tensor::MatrixMap<RTensor>;
+  template class tensor::KronMap<RTensor>;
 
 }
@@ -23,5 +23,8 @@ namespace tensor {
 
   // Explicitely instantiate an specialization of MatrixMap
   template class tensor::MatrixMap<RSparse>;
+  template class tensor::MatrixMap<RSparse, CTensor>;
+  template class tensor::KronMap<RSparse>;
+  template class tensor::MatrixMap<RHermitianSparse>;
 
 }
@@ -23,5 +23,7 @@ namespace tensor {
 
   // Explicitely instantiate an specialization of MatrixMap
   template class tensor::MatrixMap<CSparse>;
+  template class tensor::KronMap<CSparse>;
+  template class tensor::MatrixMap<CHermitianSparse>;
 
 }
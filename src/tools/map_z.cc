@@ -23,5 +23,6 @@ namespace tensor {
 
   // Explicitely instantiate an specialization of MatrixMap
   template class tensor::MatrixMap<CTensor>;
+  template class tensor::KronMap<CTensor>;
 
 }
@@ -75,6 +75,91 @@ namespace tensor_test {
     std::cout << std::endl;
   }
 
+  // Contractions over tiny indices with larger outer dimensions, which
+  // are handled by the unrolled kernels instead of BLAS.
+  template<typename elt_t>
+  void test_fold_small(index outer_dim) {
+    for (index d = 1; d <= 5; d++) {
+      Tensor<elt_t> A = Tensor<elt_t>::random(outer_dim, d, 3);
+      Tensor<elt_t> B = Tensor<elt_t>::random(d, outer_dim);
+      Tensor<elt_t> C = Tensor<elt_t>::random(2, outer_dim, d);
+      EXPECT_TRUE(approx_eq(fold(A, 1, B, 0), slow_fold(A, 1, B, 0)));
+      EXPECT_TRUE(approx_eq(fold(A, 1, C, 2), slow_fold(A, 1, C, 2)));
+      EXPECT_TRUE(approx_eq(fold(B, 0, C, 2), slow_fold(B, 0, C, 2)));
+      EXPECT_TRUE(approx_eq(foldc(A, 1, C, 2), slow_fold(conj(A), 1, C, 2)));
+      EXPECT_TRUE(approx_eq(foldc(B, 0, A, 1), slow_fold(conj(B), 0, A, 1)));
+      Tensor<elt_t> M = Tensor<elt_t>::random(d, d);
+      EXPECT_TRUE(approx_eq(mmult(M, B), slow_fold(M, 1, B, 0)));
+      EXPECT_TRUE(approx_eq(mmult(transpose(B), M), slow_fold(B, 0, M, 0)));
+    }
+  }
+
+  template<typename n1, typename n2>
+  void test_foldc(index max_dim) {
+    for (int rankA = 1; rankA <= 3; rankA++) {
+      for (int rankB = 1; rankB <= 3; rankB++) {
+        for (DimensionIterator dA(rankA,max_dim); dA; ++dA) {
+          Tensor<n1> A(*dA);
+          for (DimensionIterator dB(rankB,max_dim); dB; ++dB) {
+            Tensor<n2> B(*dB);
+            for (int i = 0; i < A.rank(); i++) {
+              for (int j = 0; j < B.rank(); j++) {
+                if (A.dimension(i) && A.dimension(i) == B.dimension(j)) {
+                  A.randomize();
+                  B.randomize();
+                  EXPECT_TRUE(approx_eq(foldc(A, i, B, j),
+                                        slow_fold(conj(A), i, B, j)));
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  template<typename elt_t>
+  void test_fold_acc(index max_dim) {
+    const elt_t alpha = number_one<elt_t>() * 0.5;
+    const elt_t beta = number_one<elt_t>() * 2.0;
+    for (int rankA = 1; rankA <= 3; rankA++) {
+      for (int rankB = 1; rankB <= 3; rankB++) {
+        for (DimensionIterator dA(rankA,max_dim); dA; ++dA) {
+          Tensor<elt_t> A(*dA);
+          for (DimensionIterator dB(rankB,max_dim); dB; ++dB) {
+            Tensor<elt_t> B(*dB);
+            for (int i = 0; i < A.rank(); i++) {
+              if (!A.dimension(i)) continue;
+              for (int j = 0; j < B.rank(); j++) {
+                if (A.dimension(i) == B.dimension(j)) {
+                  A.randomize();
+                  B.randomize();
+                  Tensor<elt_t> C0 = fold(A,i,B,j);
+                  C0.randomize();
+                  Tensor<elt_t> C = C0 + number_zero<elt_t>();
+                  const elt_t *p = C.begin_const();
+                  fold_acc(C, alpha, A, i, B, j, beta);
+                  EXPECT_EQ(p, C.begin_const());
+                  EXPECT_TRUE(approx_eq(C, alpha * fold(A,i,B,j) + beta * C0));
+
+                  C = C0 + number_zero<elt_t>();
+                  foldc_acc(C, alpha, A, i, B, j, beta);
+                  EXPECT_TRUE(approx_eq(C, alpha * foldc(A,i,B,j) + beta * C0));
+
+                  Tensor<elt_t> D0 = foldin(A,i,B,j);
+                  D0.randomize();
+                  Tensor<elt_t> D = D0 + number_zero<elt_t>();
+                  foldin_acc(D, alpha, A, i, B, j, beta);
+                  EXPECT_TRUE(approx_eq(D, alpha * foldin(A,i,B,j) + beta * D0));
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
   template<typename n1, typename n2>
   void test_fold_death() {
     for (int rankA = 1; rankA <= 4; rankA++) {
@@ -106,6 +191,15 @@ namespace tensor_test {
     test_fold<double,double>(MATRIX_MAX_DIM);
   }
 
+  TEST(FoldTest, FoldAccDoubleTest) {
+    test_fold_acc<double>(4);
+  }
+
+  TEST(FoldTest, FoldSmallDoubleTest) {
+    test_fold_small<double>(3);
+    test_fold_small<double>(17);
+  }
+
   TEST(FoldTest, FoldDoubleDoubleDeathTest) {
     test_fold_death<double,double>();
   }
@@ -118,8 +212,46 @@ namespace tensor_test {
     test_fold<cdouble,cdouble>(MATRIX_MAX_DIM);
   }
 
+  TEST(FoldTest, FoldcCdoubleCdoubleTest) {
+    test_foldc<cdouble,cdouble>(6);
+  }
+
+  TEST(FoldTest, FoldAccCdoubleTest) {
+    test_fold_acc<cdouble>(4);
+  }
+
+  TEST(FoldTest, FoldSmallCdoubleTest) {
+    test_fold_small<cdouble>(3);
+    test_fold_small<cdouble>(17);
+  }
+
   TEST(FoldTest, FoldCdoubleCdoubleDeathTest) {
     test_fold_death<cdouble,cdouble>();
   }
 
+  //////////////////////////////////////////////////////////////////////
+  // MIXED SPECIALIZATIONS
+  //
+
+  TEST(FoldTest, FoldDoubleCdoubleTest) {
+    test_fold<double,cdouble>(MATRIX_MAX_DIM);
+  }
+
+  TEST(FoldTest, FoldCdoubleDoubleTest) {
+    test_fold<cdouble,double>(MATRIX_MAX_DIM);
+  }
+
+  TEST(FoldTest, FoldDoubleCdoubleDeathTest) {
+    test_fold_death<double,cdouble>();
+    test_fold_death<cdouble,double>();
+  }
+
+  TEST(FoldTest, FoldcDoubleCdoubleTest) {
+    test_foldc<double,cdouble>(4);
+  }
+
+  TEST(FoldTest, FoldcCdoubleDoubleTest) {
+    test_foldc<cdouble,double>(4);
+  }
+
 } // namespace tensor_test
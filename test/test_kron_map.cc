@@ -0,0 +1,132 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "loops.h"
+#include <gtest/gtest.h>
+#include <tensor/tensor.h>
+#include <tensor/sparse.h>
+#include <tensor/map.h>
+#include <tensor/linalg.h>
+
+namespace tensor_test {
+
+  using namespace tensor;
+  using tensor::index;
+
+  //////////////////////////////////////////////////////////////////////
+  // LAZY KRONECKER PRODUCTS
+  //
+
+  template<typename elt_t>
+  const Tensor<elt_t> make_factor(const Tensor<elt_t> *, index rows, index cols)
+  {
+    return Tensor<elt_t>::random(rows, cols);
+  }
+
+  template<typename elt_t>
+  const Sparse<elt_t> make_factor(const Sparse<elt_t> *, index rows, index cols)
+  {
+    return Sparse<elt_t>::random(rows, cols, 0.5);
+  }
+
+  template<typename elt_t>
+  const Tensor<elt_t> dense(const Tensor<elt_t> &t) { return t; }
+
+  template<typename elt_t>
+  const Tensor<elt_t> dense(const Sparse<elt_t> &s) { return full(s); }
+
+  template<class Matrix>
+  void test_kron_map(index max_dim) {
+    typedef typename Matrix::elt_t elt_t;
+    for (index a_rows = 1; a_rows <= max_dim; a_rows++)
+    for (index a_cols = 1; a_cols <= max_dim; a_cols++)
+    for (index b_rows = 1; b_rows <= max_dim; b_rows++)
+    for (index b_cols = 1; b_cols <= max_dim; b_cols++) {
+      Matrix A1 = make_factor((Matrix *)0, a_rows, a_cols);
+      Matrix B1 = make_factor((Matrix *)0, b_rows, b_cols);
+      Matrix A2 = make_factor((Matrix *)0, a_rows, a_cols);
+      Matrix B2 = make_factor((Matrix *)0, b_rows, b_cols);
+      Tensor<elt_t> x = Tensor<elt_t>::random(a_cols * b_cols);
+      Tensor<elt_t> X = Tensor<elt_t>::random(a_cols * b_cols, 3);
+
+      KronMap<Matrix> map(A1, B1);
+      EXPECT_EQ(map.rows(), a_rows * b_rows);
+      EXPECT_EQ(map.columns(), a_cols * b_cols);
+      Tensor<elt_t> K = dense(kron(A1, B1));
+      EXPECT_CEQ3(map(x), mmult(K, x), 1e-12);
+
+      map.add(A2, B2);
+      K = K + dense(kron(A2, B2));
+      EXPECT_CEQ3(map(x), mmult(K, x), 1e-12);
+      EXPECT_CEQ3(map(X), mmult(K, X), 1e-12);
+    }
+  }
+
+  TEST(KronMapTest, RTensor) {
+    test_kron_map<RTensor>(3);
+  }
+
+  TEST(KronMapTest, CTensor) {
+    test_kron_map<CTensor>(3);
+  }
+
+  TEST(KronMapTest, RSparse) {
+    test_kron_map<RSparse>(3);
+  }
+
+  TEST(KronMapTest, CSparse) {
+    test_kron_map<CSparse>(3);
+  }
+
+  TEST(KronMapTest, Errors) {
+    KronMap<RTensor> map(RTensor::random(2,3), RTensor::random(4,5));
+    ASSERT_DEATH(map.add(RTensor::random(3,2), RTensor::random(4,5)), ".*");
+    ASSERT_DEATH(map(RTensor::random(14)), ".*");
+  }
+
+  //////////////////////////////////////////////////////////////////////
+  // LINEAR ALGEBRA WITH LAZY KRONECKER PRODUCTS
+  //
+
+  TEST(KronMapTest, Cgs) {
+    RTensor A = RTensor::random(4,4), B = RTensor::random(5,5);
+    A = mmult(A, transpose(A)) + 4.0 * RTensor::eye(4);
+    B = mmult(B, transpose(B)) + 5.0 * RTensor::eye(5);
+    KronMap<RTensor> map(A, B);
+    map.add(RTensor::eye(4), B);
+    RTensor y = RTensor::random(20);
+    RTensor x = linalg::cgs(map, y, (const RTensor *)0, 0, 1e-12);
+    EXPECT_CEQ3(map(x), y, 1e-9);
+    EXPECT_CEQ3(mmult(kron(A, B) + kron(RTensor::eye(4), B), x), y, 1e-9);
+  }
+
+  TEST(KronMapTest, Eigs) {
+    RSparse A = RSparse::random(6,6), B = RSparse::random(7,7);
+    A = A + transpose(A);
+    B = B + transpose(B);
+    KronMap<RSparse> map(A, RSparse::eye(7));
+    map.add(RSparse::eye(6), B);
+    RTensor v;
+    RTensor E = linalg::eigs(map, map.columns(), linalg::LargestMagnitude, 1, &v);
+    RTensor H = full(kron(A, RSparse::eye(7)) + kron(RSparse::eye(6), B));
+    RTensor Efull = linalg::eig_sym(H);
+    EXPECT_CEQ3(abs(E(0)), max(abs(Efull)), 1e-9);
+  }
+
+} // namespace tensor_test
@@ -21,6 +21,7 @@
 #include <gtest/gtest.h>
 #include <tensor/tensor.h>
 #include <tensor/linalg.h>
+#include <tensor/sparse.h>
 
 namespace tensor_test {
 
@@ -159,6 +160,25 @@ namespace tensor_test {
     }
   }
 
+  void test_cgs_real_sparse_complex(int n) {
+    // A real sparse matrix acting on complex vectors
+    for (int cols = 1; cols < n; cols++) {
+      RSparse B = RSparse(RTensor::eye(n) + 0.125 * random_permutation(n));
+      RSparse A = mmult(transpose(B), B);
+      CTensor x = CTensor::random(n, cols);
+      CTensor y = mmult(A, x);
+      EXPECT_CEQ(y, mmult(CSparse(A), x));
+
+      CTensor x_start = x + CTensor::random(n,cols)*0.02;
+      CTensor x0 = cgs(A, y, &x_start, 0, 2*EPSILON);
+      EXPECT_CEQ(x, x0);
+    }
+  }
+
+  TEST(CCgs, RealSparse) {
+    test_over_integers(1, 22, test_cgs_real_sparse_complex);
+  }
+
   //////////////////////////////////////////////////////////////////////
   // REAL SPECIALIZATIONS
   //
@@ -0,0 +1,110 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "loops.h"
+#include <gtest/gtest.h>
+#include <tensor/tensor.h>
+#include <tensor/sparse.h>
+#include "linalg/find_blocks.hpp"
+
+namespace tensor_test {
+
+  using namespace tensor;
+
+  /* A matrix with 'nblocks' dense blocks, whose rows and columns are
+     scattered with a fixed permutation. Row and column 'n' are empty. */
+  template<typename elt_t>
+  const Tensor<elt_t> scattered_blocks(tensor::index nblocks, tensor::index n) {
+    tensor::index N = nblocks * n + 1;
+    Tensor<elt_t> A = Tensor<elt_t>::zeros(N, N);
+    for (tensor::index b = 0; b < nblocks; b++)
+      for (tensor::index i = 0; i < n; i++)
+        for (tensor::index j = 0; j <= i; j++) {
+          // Row r of the block is (r * nblocks + b), shifted past row n
+          tensor::index r = i * nblocks + b, c = j * nblocks + b;
+          A.at(r + (r >= n), c + (c >= n)) = number_one<elt_t>();
+        }
+    return A;
+  }
+
+  template<typename elt_t>
+  void check_blocks(const Tensor<elt_t> &A, tensor::index nblocks,
+                    const std::vector<Indices> &rows,
+                    const std::vector<Indices> &cols) {
+    ASSERT_EQ(rows.size(), (size_t)nblocks);
+    ASSERT_EQ(cols.size(), (size_t)nblocks);
+    Tensor<elt_t> B = A;
+    tensor::index total = 0;
+    for (tensor::index b = 0; b < nblocks; b++) {
+      // Blocks are ordered by their first column
+      if (b) EXPECT_LT(cols[b-1][0], cols[b][0]);
+      total += rows[b].size() * cols[b].size();
+      B.at(range(rows[b]), range(cols[b])) =
+        Tensor<elt_t>::zeros(rows[b].size(), cols[b].size());
+    }
+    // Blocks cover all nonzero elements and no more
+    EXPECT_TRUE(all_equal(B, Tensor<elt_t>::zeros(A.rows(), A.columns())));
+    EXPECT_EQ(total, (A.rows() - 1) * (A.columns() - 1) / nblocks);
+  }
+
+  template<typename elt_t>
+  void test_find_blocks(int nblocks) {
+    for (tensor::index n = 1; n < 5; n++) {
+      Tensor<elt_t> A = scattered_blocks<elt_t>(nblocks, n);
+      std::vector<Indices> rows, cols;
+      bool found = linalg::find_blocks(A, &rows, &cols);
+      std::vector<Indices> srows, scols;
+      bool sfound = linalg::find_blocks(Sparse<elt_t>(A), &srows, &scols);
+      EXPECT_EQ(found, nblocks > 1);
+      EXPECT_EQ(sfound, nblocks > 1);
+      if (nblocks > 1) {
+        check_blocks(A, nblocks, rows, cols);
+        for (int b = 0; b < nblocks; b++) {
+          EXPECT_TRUE(all_equal(rows[b], srows[b]));
+          EXPECT_TRUE(all_equal(cols[b], scols[b]));
+        }
+      }
+    }
+  }
+
+  TEST(FindBlocks, Real) {
+    test_over_integers(1, 7, test_find_blocks<double>);
+  }
+
+  TEST(FindBlocks, Complex) {
+    test_over_integers(1, 7, test_find_blocks<cdouble>);
+  }
+
+  TEST(FindBlocks, Tolerance) {
+    // Small elements do not link blocks
+    RTensor A = RTensor::eye(6, 6);
+    A.at(0, 5) = 1e-3;
+    std::vector<Indices> rows, cols;
+    EXPECT_TRUE(linalg::find_blocks(A, &rows, &cols, 1e-2));
+    EXPECT_EQ(rows.size(), 6);
+    EXPECT_TRUE(linalg::find_blocks(A, &rows, &cols));
+    EXPECT_EQ(rows.size(), 5);
+    EXPECT_TRUE(all_equal(rows[0], igen << 0 << 5));
+    EXPECT_TRUE(all_equal(cols[0], igen << 0 << 5));
+    EXPECT_TRUE(linalg::find_blocks(RSparse(A), &rows, &cols));
+    EXPECT_EQ(rows.size(), 5);
+    EXPECT_FALSE(linalg::find_blocks(RTensor::ones(igen << 3 << 4), &rows, &cols));
+  }
+
+} // namespace tensor_test
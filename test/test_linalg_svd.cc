@@ -121,6 +121,38 @@ namespace tensor_test {
     }
   }
 
+  /* Block diagonal matrix with 'nblocks' random square blocks of sizes 1 to
+     4, whose rows and columns are shuffled. */
+  template<typename elt_t>
+  void test_random_block_svd(int nblocks) {
+    tensor::index N = 0;
+    for (int b = 0; b < nblocks; b++)
+      N += b % 4 + 1;
+    Tensor<elt_t> A = Tensor<elt_t>::zeros(N, N);
+    for (tensor::index b = 0, i = 0; b < nblocks; b++) {
+      tensor::index n = b % 4 + 1;
+      RTensor s;
+      A.at(range(i, i + n - 1), range(i, i + n - 1)) =
+        random_svd_matrix<elt_t>(n, n, s);
+      i += n;
+    }
+    Indices prow = iota(0, N-1), pcol = iota(0, N-1);
+    std::random_shuffle(prow.begin(), prow.end());
+    std::random_shuffle(pcol.begin(), pcol.end());
+    A = A(range(prow), range(pcol));
+
+    RTensor true_s = linalg::svd(A);
+    for (int economic = 0; economic < 2; economic++) {
+      Tensor<elt_t> U, Vt;
+      RTensor s = linalg::block_svd(A, &U, &Vt, economic);
+      EXPECT_TRUE(approx_eq(true_s, s));
+      EXPECT_TRUE(unitaryp(U, 1e-10));
+      EXPECT_TRUE(unitaryp(Vt, 1e-10));
+      EXPECT_TRUE(approx_eq(A, mmult(U, mmult(diag(s), Vt))));
+      EXPECT_TRUE(approx_eq(s, linalg::block_svd(A, 0, 0, economic)));
+    }
+  }
+
   //////////////////////////////////////////////////////////////////////
   // REAL SPECIALIZATIONS
   //
@@ -141,6 +173,10 @@ namespace tensor_test {
     test_over_integers(0, 32, test_random_svd<double,true>);
   }
 
+  TEST(RMatrixTest, RandomManyBlocksSvdTest) {
+    test_over_integers(1, 40, test_random_block_svd<double>);
+  }
+
   //////////////////////////////////////////////////////////////////////
   // COMPLEX SPECIALIZATIONS
   //
@@ -161,4 +197,8 @@ namespace tensor_test {
     test_over_integers(0, 32, test_random_svd<cdouble,true>);
   }
 
+  TEST(CMatrixTest, RandomManyBlocksSvdTest) {
+    test_over_integers(1, 40, test_random_block_svd<cdouble>);
+  }
+
 } // namespace linalg_test
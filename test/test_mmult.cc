@@ -34,7 +34,8 @@ namespace tensor_test {
     for (index i = 1; i <= max_dim; i++) {
       for (index j = 1; j <= max_dim; j++) {
         for (index k = 1; k <= max_dim; k++) {
-          Tensor<n1> A(i,j), B(j,k);
+          Tensor<n1> A(i,j);
+          Tensor<n2> B(j,k);
           A.randomize();
           B.randomize();
           EXPECT_TRUE(approx_eq(mmult(A, B), fold_22_12(A, B)));
@@ -61,4 +62,12 @@ namespace tensor_test {
     test_mmult<cdouble,cdouble>(MATRIX_MAX_DIM);
   }
 
+  TEST(MmultTest, MmultDoubleCdoubleTest) {
+    test_mmult<double,cdouble>(MATRIX_MAX_DIM);
+  }
+
+  TEST(MmultTest, MmultCdoubleDoubleTest) {
+    test_mmult<cdouble,double>(MATRIX_MAX_DIM);
+  }
+
 } // namespace tensor_test
@@ -84,3 +84,64 @@ TEST(SDF, CTensor) {
   }
   unlink("foo.dat");
 }
+
+template<typename elt_t>
+void test_sdf_sparse() {
+  Sparse<elt_t> a;
+  Sparse<elt_t> b = Sparse<elt_t>::random(13, 7);
+  Sparse<elt_t> c = Sparse<elt_t>::eye(20);
+  Sparse<elt_t> d(3, 5, 4);
+  {
+    OutDataFile f("foo.dat");
+    f.dump(a, "a");
+    f.dump(b, "b");
+    f.dump(c, "c");
+    f.dump(d, "d");
+  }
+  {
+    InDataFile f("foo.dat");
+    Sparse<elt_t> aux;
+    f.load(&aux, "a");
+    EXPECT_TRUE(all_equal(a, aux));
+    f.load(&aux, "b");
+    EXPECT_TRUE(all_equal(b, aux));
+    f.load(&aux, "c");
+    EXPECT_TRUE(all_equal(c, aux));
+    f.load(&aux, "d");
+    EXPECT_TRUE(all_equal(full(d), full(aux)));
+  }
+  unlink("foo.dat");
+}
+
+static void load_sparse_file(const Sparse<double> &s) {
+  {
+    OutDataFile f("foo.dat");
+    f.dump(s);
+  }
+  InDataFile f("foo.dat");
+  Sparse<double> aux;
+  f.load(&aux);
+}
+
+TEST(SDF, RSparse) {
+  test_sdf_sparse<double>();
+}
+
+TEST(SDF, CorruptSparse) {
+  Indices dims = igen << 2 << 3;
+  RTensor data = RTensor::ones(igen << 2);
+  // Column out of range
+  ASSERT_DEATH(load_sparse_file(Sparse<double>(dims, igen << 0 << 1 << 2,
+                                               igen << 0 << 3, data)), ".*");
+  // Columns not increasing within a row
+  ASSERT_DEATH(load_sparse_file(Sparse<double>(dims, igen << 0 << 2 << 2,
+                                               igen << 1 << 0, data)), ".*");
+  // Decreasing row offsets
+  ASSERT_DEATH(load_sparse_file(Sparse<double>(dims, igen << 0 << 2 << 1,
+                                               igen << 0 << 1, data)), ".*");
+  unlink("foo.dat");
+}
+
+TEST(SDF, CSparse) {
+  test_sdf_sparse<cdouble>();
+}
@@ -318,6 +318,11 @@ namespace tensor_test {
     test_over_fixed_rank_tensors<cdouble>(test_sparse_random<cdouble>, 2, 7);
   }
 
+  template<typename elt_t>
+  bool is_nonzero(const elt_t &x) {
+    return !(x == number_zero<elt_t>());
+  }
+
   //
   // SPARSE <-> FULL CONVERSION, ARBITRARY SIZES
   //
@@ -354,6 +359,50 @@ namespace tensor_test {
     test_over_fixed_rank_tensors<cdouble>(test_full<cdouble>, 2, 7);
   }
 
+  //
+  // CONVERSION WITH A TOLERANCE
+  //
+  template<typename elt_t>
+  void test_full_tolerance(Tensor<elt_t> &t) {
+    const double tolerance = 0.5;
+    Tensor<elt_t> small = t;
+    for (tensor::index i = 0; i < small.size(); i++) {
+      if (abs(small[i]) <= tolerance)
+        small.at(i) = number_zero<elt_t>();
+    }
+    Sparse<elt_t> s(t, tolerance);
+    EXPECT_TRUE(all_equal(s, Sparse<elt_t>(small)));
+    EXPECT_TRUE(all_equal(full(s), small));
+    EXPECT_TRUE(all_equal(Sparse<elt_t>(t, 0.0), Sparse<elt_t>(t)));
+  }
+
+  TEST(RSparseTest, RSparseFullTolerance) {
+    test_over_fixed_rank_tensors<double>(test_full_tolerance<double>, 2, 7);
+  }
+
+  TEST(CSparseTest, CSparseFullTolerance) {
+    test_over_fixed_rank_tensors<cdouble>(test_full_tolerance<cdouble>, 2, 7);
+  }
+
+  template<typename elt_t>
+  void test_full_large() {
+    // Large enough to be split among threads
+    Sparse<elt_t> s = Sparse<elt_t>::random(600, 500, 0.1);
+    Tensor<elt_t> t = full(s);
+    EXPECT_TRUE(all_equal(Sparse<elt_t>(t), s));
+    EXPECT_EQ(s.length(), std::count_if(t.begin(), t.end(), is_nonzero<elt_t>));
+    Sparse<elt_t> row = Sparse<elt_t>::random(1, 100000, 0.1);
+    EXPECT_TRUE(all_equal(Sparse<elt_t>(full(row)), row));
+  }
+
+  TEST(RSparseTest, RSparseFullLarge) {
+    test_full_large<double>();
+  }
+
+  TEST(CSparseTest, CSparseFullLarge) {
+    test_full_large<cdouble>();
+  }
+
   //
   // SPARSE -> COMPLEX CONVERSION, ARBITRARY SIZES
   //
@@ -377,6 +426,127 @@ namespace tensor_test {
   }
 
 
+  //
+  // CONSTRUCTION FROM COORDINATES
+  //
+
+  template<typename elt_t>
+  void test_coordinates(tensor::index rows, tensor::index cols, tensor::index n) {
+    Indices r(n), c(n);
+    Tensor<elt_t> v = Tensor<elt_t>::random(n);
+    Tensor<elt_t> expected = Tensor<elt_t>::zeros(rows, cols);
+    for (tensor::index i = 0; i < n; i++) {
+      // Repeated elements, in any order, some cancelling the others.
+      r.at(i) = tensor::rand<unsigned long>() % rows;
+      c.at(i) = tensor::rand<unsigned long>() % cols;
+      if (i && (i % 7 == 0)) {
+        r.at(i) = r[i-1];
+        c.at(i) = c[i-1];
+        v.at(i) = -v[i-1];
+      }
+      expected.at(r[i], c[i]) += v[i];
+    }
+    Sparse<elt_t> S(r, c, v, rows, cols);
+    EXPECT_EQ(rows, S.rows());
+    EXPECT_EQ(cols, S.columns());
+    EXPECT_TRUE(approx_eq(full(S), expected));
+    // Structure is the same as the one obtained from a full matrix
+    Sparse<elt_t> S2(full(S));
+    EXPECT_TRUE(all_equal(S.priv_row_start(), S2.priv_row_start()));
+    EXPECT_TRUE(all_equal(S.priv_column(), S2.priv_column()));
+  }
+
+  template<typename elt_t>
+  void test_coordinate_constructor() {
+    for (tensor::index rows = 1; rows < 7; rows++)
+      for (tensor::index cols = 1; cols < 7; cols++)
+        test_coordinates<elt_t>(rows, cols, 3 * rows * cols);
+    // Large enough to be processed in parallel
+    test_coordinates<elt_t>(300, 200, 200000);
+    // Dimensions deduced from the coordinates
+    Sparse<elt_t> S(igen << 2 << 0, igen << 1 << 3, Tensor<elt_t>::ones(igen << 2));
+    EXPECT_EQ(3, S.rows());
+    EXPECT_EQ(4, S.columns());
+  }
+
+  TEST(RSparseTest, RSparseCoordinateConstructor) {
+    test_coordinate_constructor<double>();
+  }
+
+  TEST(CSparseTest, CSparseCoordinateConstructor) {
+    test_coordinate_constructor<cdouble>();
+  }
+
+  //
+  // INCREMENTAL CONSTRUCTION
+  //
+
+  template<typename elt_t>
+  void test_builder(tensor::index rows, tensor::index cols, tensor::index n) {
+    Indices r(n), c(n);
+    Tensor<elt_t> v = Tensor<elt_t>::random(n);
+    for (tensor::index i = 0; i < n; i++) {
+      r.at(i) = tensor::rand<unsigned long>() % rows;
+      c.at(i) = tensor::rand<unsigned long>() % cols;
+      if (i && (i % 7 == 0)) {
+        r.at(i) = r[i-1];
+        c.at(i) = c[i-1];
+        v.at(i) = -v[i-1];
+      }
+    }
+    Sparse<elt_t> expected(r, c, v, rows, cols);
+    // Elements added from one thread are summed in the same order
+    SparseBuilder<elt_t> builder(rows, cols);
+    for (tensor::index i = 0; i < n; i++)
+      builder.add(r[i], c[i], v[i]);
+    EXPECT_EQ(rows, builder.rows());
+    EXPECT_EQ(cols, builder.columns());
+    EXPECT_TRUE(all_equal(builder.finalize(), expected));
+    EXPECT_EQ(0, builder.length());
+    // Elements added concurrently
+    const tensor::index *pr = r.begin();
+    const tensor::index *pc = c.begin();
+    const elt_t *pv = v.begin();
+#pragma omp parallel for
+    for (tensor::index i = 0; i < n; i++)
+      builder.add(pr[i], pc[i], pv[i]);
+    Sparse<elt_t> S = builder.finalize();
+    EXPECT_TRUE(all_equal(S.dimensions(), expected.dimensions()));
+    EXPECT_TRUE(approx_eq(full(S), full(expected)));
+    // Inside nested regions with a single thread
+#pragma omp parallel for
+    for (tensor::index i = 0; i < n; i++) {
+#pragma omp parallel if (0)
+      builder.add(pr[i], pc[i], pv[i]);
+    }
+    S = builder.finalize();
+    EXPECT_TRUE(approx_eq(full(S), full(expected)));
+  }
+
+  template<typename elt_t>
+  void test_sparse_builder() {
+    for (tensor::index rows = 1; rows < 7; rows++)
+      for (tensor::index cols = 1; cols < 7; cols++)
+        test_builder<elt_t>(rows, cols, 3 * rows * cols);
+    test_builder<elt_t>(300, 200, 200000);
+    // No elements
+    SparseBuilder<elt_t> builder(3, 4);
+    EXPECT_TRUE(all_equal(builder.finalize(), Sparse<elt_t>(3, 4)));
+    // Elements can be discarded
+    builder.add(1, 2, number_one<elt_t>());
+    EXPECT_EQ(1, builder.length());
+    builder.clear();
+    EXPECT_EQ(0, builder.length());
+  }
+
+  TEST(RSparseTest, RSparseBuilder) {
+    test_sparse_builder<double>();
+  }
+
+  TEST(CSparseTest, CSparseBuilder) {
+    test_sparse_builder<cdouble>();
+  }
+
   //
   // REAL PART OF SPARSE MATRICES
   //
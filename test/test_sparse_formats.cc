@@ -0,0 +1,280 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <tensor/tensor.h>
+#include <tensor/sparse.h>
+#include <tensor/map.h>
+#include <tensor/linalg.h>
+#include "loops.h"
+#include <gtest/gtest.h>
+
+namespace tensor_test {
+
+  using namespace tensor;
+
+  template<typename Matrix, typename elt_t>
+  void test_format_mmult(const Matrix &M, const Sparse<elt_t> &S,
+                         double epsilon = 2*EPSILON) {
+    EXPECT_TRUE(all_equal(M.dimensions(), S.dimensions()));
+    tensor::index cols = S.columns();
+    {
+      Tensor<elt_t> B = Tensor<elt_t>::random(igen << cols);
+      EXPECT_TRUE(approx_eq(mmult(M, B), mmult(S, B), epsilon));
+    }
+    for (tensor::index n = 1; n < 4; n++) {
+      Tensor<elt_t> B = Tensor<elt_t>::random(cols, n);
+      EXPECT_TRUE(approx_eq(mmult(M, B), mmult(S, B), epsilon));
+      Tensor<elt_t> C = Tensor<elt_t>::random(cols, 2, n);
+      EXPECT_TRUE(approx_eq(mmult(M, C), mmult(S, C), epsilon));
+    }
+  }
+
+  static const CompactIndices to_compact(const Indices &i) {
+    CompactIndices output(i.size());
+    std::copy(i.begin(), i.end(), output.begin());
+    return output;
+  }
+
+  //
+  // CSR MATRICES WITH 32-BIT COLUMNS
+  //
+
+  template<typename elt_t>
+  void test_compact_sparse(Tensor<elt_t> &t) {
+    Sparse<elt_t> S = Sparse<elt_t>::random(t.rows(), t.columns());
+    CompactSparse<elt_t> M(S);
+    EXPECT_EQ(S.length(), M.length());
+    EXPECT_TRUE(M.priv_column() == to_compact(S.priv_column()));
+    // Values and row structure are shared
+    EXPECT_EQ(S.priv_data().begin(), M.priv_data().begin());
+    EXPECT_EQ(S.priv_row_start().begin(), M.priv_row_start().begin());
+    test_format_mmult(M, S);
+    if (S.rows()) {
+      for (tensor::index n = 1; n < 4; n++) {
+        Tensor<elt_t> B = Tensor<elt_t>::random(n, S.rows());
+        EXPECT_TRUE(approx_eq(mmult(B, M), mmult(B, S)));
+      }
+    }
+  }
+
+  TEST(CompactSparseTest, RCompactSparse) {
+    test_over_fixed_rank_tensors<double>(test_compact_sparse<double>, 2, 7);
+  }
+
+  TEST(CompactSparseTest, CCompactSparse) {
+    test_over_fixed_rank_tensors<cdouble>(test_compact_sparse<cdouble>, 2, 7);
+  }
+
+  //
+  // BLOCK COMPRESSED ROW MATRICES
+  //
+
+  template<typename elt_t>
+  void test_block_sparse(Tensor<elt_t> &t) {
+    Sparse<elt_t> S = Sparse<elt_t>::random(t.rows(), t.columns());
+    for (tensor::index block = 1; block < 5; block++) {
+      BlockSparse<elt_t> B(S, block);
+      EXPECT_EQ(block, B.block_size());
+      test_format_mmult(B, S);
+    }
+  }
+
+  template<typename elt_t>
+  void test_block_sparse_structure() {
+    // Two dense 2x2 blocks and an incomplete block in the corner
+    Tensor<elt_t> t = Tensor<elt_t>::zeros(5, 5);
+    t.at(0,0) = 1.0; t.at(1,0) = 2.0; t.at(0,1) = 3.0; t.at(1,1) = 4.0;
+    t.at(2,2) = 5.0; t.at(3,3) = 6.0;
+    t.at(4,4) = 7.0;
+    BlockSparse<elt_t> B(Sparse<elt_t>(t), 2);
+    EXPECT_EQ(3, B.length());
+    EXPECT_TRUE(all_equal(B.priv_block_row_start(), igen << 0 << 1 << 2 << 3));
+    EXPECT_TRUE(all_equal(B.priv_block_column(), igen << 0 << 1 << 2));
+    EXPECT_EQ(number_one<elt_t>() * 2.0, B.priv_data()[1]);
+    EXPECT_EQ(number_one<elt_t>() * 3.0, B.priv_data()[2]);
+  }
+
+  TEST(BlockSparseTest, RBlockSparse) {
+    test_over_fixed_rank_tensors<double>(test_block_sparse<double>, 2, 7);
+    test_block_sparse_structure<double>();
+  }
+
+  TEST(BlockSparseTest, CBlockSparse) {
+    test_over_fixed_rank_tensors<cdouble>(test_block_sparse<cdouble>, 2, 7);
+    test_block_sparse_structure<cdouble>();
+  }
+
+  TEST(BlockSparseTest, BlockSizeError) {
+    RSparse S = RSparse::random(4, 4);
+    ASSERT_DEATH(RBlockSparse(S, 0), "block size");
+    ASSERT_DEATH(RBlockSparse(S, -2), "block size");
+  }
+
+  //
+  // SELL-C-SIGMA MATRICES
+  //
+
+  template<typename elt_t>
+  void test_sliced_sparse(Tensor<elt_t> &t) {
+    Sparse<elt_t> S = Sparse<elt_t>::random(t.rows(), t.columns());
+    for (tensor::index chunk = 1; chunk < 5; chunk++) {
+      for (tensor::index sigma = 1; sigma < 8; sigma *= 2) {
+        SlicedSparse<elt_t> M(S, chunk, sigma);
+        EXPECT_EQ(chunk, M.chunk_size());
+        EXPECT_LE(S.length(), M.length());
+        test_format_mmult(M, S);
+      }
+    }
+  }
+
+  template<typename elt_t>
+  void test_sliced_sparse_structure() {
+    // Rows with 1, 3, 0 and 2 elements, sorted as 3, 2, 1, 0 elements
+    Tensor<elt_t> t = Tensor<elt_t>::zeros(4, 3);
+    t.at(0,1) = 1.0;
+    t.at(1,0) = 2.0; t.at(1,1) = 3.0; t.at(1,2) = 4.0;
+    t.at(3,0) = 5.0; t.at(3,2) = 6.0;
+    SlicedSparse<elt_t> M(Sparse<elt_t>(t), 2, 4);
+    EXPECT_TRUE(all_equal(M.priv_row(), igen << 1 << 3 << 0 << 2));
+    EXPECT_TRUE(all_equal(M.priv_chunk_start(), igen << 0 << 6 << 8));
+    // Chunks stored column by column, padded with zeros in column 0
+    EXPECT_TRUE(M.priv_column() ==
+                CompactIndices(to_compact(igen << 0 << 0 << 1 << 2 << 2 << 0
+                                          << 1 << 0)));
+    EXPECT_EQ(number_zero<elt_t>(), M.priv_data()[5]);
+  }
+
+  TEST(SlicedSparseTest, RSlicedSparse) {
+    test_over_fixed_rank_tensors<double>(test_sliced_sparse<double>, 2, 7);
+    test_sliced_sparse_structure<double>();
+  }
+
+  TEST(SlicedSparseTest, CSlicedSparse) {
+    test_over_fixed_rank_tensors<cdouble>(test_sliced_sparse<cdouble>, 2, 7);
+    test_sliced_sparse_structure<cdouble>();
+  }
+
+  //
+  // HERMITIAN MATRICES
+  //
+
+  template<typename elt_t>
+  void test_hermitian_sparse(const Sparse<elt_t> &S, double epsilon = 2*EPSILON) {
+    Sparse<elt_t> H = S + adjoint(S);
+    HermitianSparse<elt_t> M(H);
+    EXPECT_LE(M.length(), H.length());
+    test_format_mmult(M, H, epsilon);
+    for (tensor::index n = 1; n < 4; n++) {
+      Tensor<elt_t> B = Tensor<elt_t>::random(n, H.rows());
+      EXPECT_TRUE(approx_eq(mmult(B, M), mmult(B, H), epsilon));
+    }
+  }
+
+  template<typename elt_t>
+  void test_hermitian_sparse_small(Tensor<elt_t> &t) {
+    test_hermitian_sparse(Sparse<elt_t>::random(t.rows(), t.rows()));
+  }
+
+  TEST(HermitianSparseTest, RHermitianSparse) {
+    test_over_fixed_rank_tensors<double>(test_hermitian_sparse_small<double>, 2, 7);
+  }
+
+  TEST(HermitianSparseTest, CHermitianSparse) {
+    test_over_fixed_rank_tensors<cdouble>(test_hermitian_sparse_small<cdouble>, 2, 7);
+  }
+
+  /* Banded matrix, large enough to be split among threads, plus a few
+     elements far from the diagonal. */
+  template<typename elt_t>
+  void test_hermitian_sparse_large() {
+    const tensor::index n = 20000, band = 5, far = 4;
+    Indices rows(n * band + far), cols(n * band + far);
+    Tensor<elt_t> data = Tensor<elt_t>::random(n * band + far);
+    for (tensor::index i = 0; i < n; i++)
+      for (tensor::index k = 0; k < band; k++) {
+        rows.at(i * band + k) = i;
+        cols.at(i * band + k) = std::min(i + k, n - 1);
+      }
+    for (tensor::index k = 0; k < far; k++) {
+      rows.at(n * band + k) = k * (n / far);
+      cols.at(n * band + k) = n - 1 - k;
+    }
+    test_hermitian_sparse(Sparse<elt_t>(rows, cols, data, n, n), 1e-12);
+  }
+
+  TEST(HermitianSparseTest, RHermitianSparseLarge) {
+    test_hermitian_sparse_large<double>();
+  }
+
+  TEST(HermitianSparseTest, CHermitianSparseLarge) {
+    test_hermitian_sparse_large<cdouble>();
+  }
+
+  TEST(HermitianSparseTest, Structure) {
+    // Only the upper triangle is kept
+    RTensor t = RTensor::zeros(3, 3);
+    t.at(0,0) = 1.0; t.at(0,2) = 2.0; t.at(2,0) = 2.0; t.at(1,1) = 3.0;
+    t.at(1,2) = 4.0; t.at(2,1) = 4.0;
+    RHermitianSparse M((RSparse(t)));
+    EXPECT_TRUE(all_equal(M.priv_row_start(), igen << 0 << 2 << 4 << 4));
+    EXPECT_TRUE(all_equal(M.priv_column(), igen << 0 << 2 << 1 << 2));
+    EXPECT_TRUE(all_equal(M.priv_data(), RTensor(igen << 4, rgen << 1.0 << 2.0 << 3.0 << 4.0)));
+  }
+
+  template<typename elt_t>
+  void test_hermitian_cgs() {
+    tensor::index n = 40;
+    Sparse<elt_t> S = Sparse<elt_t>::random(n, n);
+    Sparse<elt_t> H = mmult(S, adjoint(S)) + Sparse<elt_t>::eye(n) * (elt_t)n;
+    MatrixMap<HermitianSparse<elt_t> > map((HermitianSparse<elt_t>(H)));
+    Tensor<elt_t> y = Tensor<elt_t>::random(igen << n);
+    Tensor<elt_t> x = linalg::cgs(map, y, (const Tensor<elt_t> *)0, 0, 1e-12);
+    EXPECT_TRUE(approx_eq(mmult(H, x), y, 1e-9));
+  }
+
+  TEST(HermitianSparseTest, RMatrixMapCgs) {
+    test_hermitian_cgs<double>();
+  }
+
+  TEST(HermitianSparseTest, CMatrixMapCgs) {
+    test_hermitian_cgs<cdouble>();
+  }
+
+  //
+  // LARGE MATRICES, SPLIT AMONG THREADS
+  //
+
+  template<typename elt_t>
+  void test_formats_large() {
+    Sparse<elt_t> S = Sparse<elt_t>::random(500, 700, 0.3);
+    test_format_mmult(BlockSparse<elt_t>(S, 4), S, 1e-12);
+    test_format_mmult(SlicedSparse<elt_t>(S), S, 1e-12);
+    test_format_mmult(CompactSparse<elt_t>(S), S, 1e-12);
+    test_hermitian_sparse(Sparse<elt_t>::random(700, 700, 0.3), 1e-12);
+  }
+
+  TEST(BlockSparseTest, RFormatsLarge) {
+    test_formats_large<double>();
+  }
+
+  TEST(BlockSparseTest, CFormatsLarge) {
+    test_formats_large<cdouble>();
+  }
+
+} // namespace tensor_test
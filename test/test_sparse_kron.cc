@@ -103,6 +103,34 @@ namespace tensor_test {
     test_over_fixed_rank_pairs<cdouble>(test_tensor_kron<cdouble>, 2);
   }
 
+  template<typename elt_t>
+  void test_kron2_sum(Tensor<elt_t> &a, Tensor<elt_t> &b)
+  {
+    Sparse<elt_t> sa = Sparse<elt_t>::random(a.rows(), a.columns());
+    Sparse<elt_t> sb = Sparse<elt_t>::random(b.rows(), b.columns());
+    // kron2_sum() adds the diagonals: make some elements cancel
+    if (a.rows() && a.columns() && b.rows() && b.columns()) {
+      a = full(sa);
+      b = full(sb);
+      a.at(0,0) = 1.0;
+      b.at(0,0) = -1.0;
+      sa = Sparse<elt_t>(a);
+      sb = Sparse<elt_t>(b);
+    }
+    Sparse<elt_t> expected =
+      kron(sb, Sparse<elt_t>::eye(a.rows(), a.columns())) +
+      kron(Sparse<elt_t>::eye(b.rows(), b.columns()), sa);
+    Sparse<elt_t> k = kron2_sum(sa, sb);
+    ASSERT_TRUE(all_equal(full(expected), full(k)));
+    ASSERT_EQ(expected.length(), k.length());
+  }
+
+  TEST(RSparseKronTest, Kron2Sum) {
+    test_over_fixed_rank_pairs<double>(test_kron2_sum<double>, 2);
+  }
 
+  TEST(CSparseKronTest, Kron2Sum) {
+    test_over_fixed_rank_pairs<cdouble>(test_kron2_sum<cdouble>, 2);
+  }
 
 } // namespace tensor_test
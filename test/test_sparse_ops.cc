@@ -19,6 +19,7 @@
 
 #include <tensor/tensor.h>
 #include <tensor/sparse.h>
+#include <tensor/map.h>
 #include "loops.h"
 #include <gtest/gtest.h>
 
@@ -105,4 +106,543 @@ namespace tensor_test {
     test_over_fixed_rank_tensors<cdouble>(test_sparse_binop_random<cdouble>, 2, 7);
   }
 
+  template<typename elt_t>
+  void test_sparse_transpose(Tensor<elt_t> &t) {
+    tensor::index rows = t.rows(), cols = t.columns();
+    Sparse<elt_t> A = Sparse<elt_t>::random(rows, cols);
+    Tensor<elt_t> fA = full(A);
+    EXPECT_TRUE(all_equal(transpose(A), Sparse<elt_t>(transpose(fA))));
+    EXPECT_TRUE(all_equal(adjoint(A), Sparse<elt_t>(adjoint(fA))));
+    EXPECT_TRUE(all_equal(transpose(transpose(A)), A));
+  }
+
+  TEST(RSparseTest, Transpose) {
+    test_over_fixed_rank_tensors<double>(test_sparse_transpose<double>, 2, 7);
+  }
+
+  TEST(CSparseTest, Transpose) {
+    test_over_fixed_rank_tensors<cdouble>(test_sparse_transpose<cdouble>, 2, 7);
+  }
+
+  template<typename elt_t>
+  void test_sparse_transpose_large() {
+    // Large enough to be split among threads
+    Sparse<elt_t> A = Sparse<elt_t>::random(500, 700, 0.3);
+    Tensor<elt_t> fA = full(A);
+    EXPECT_TRUE(all_equal(transpose(A), Sparse<elt_t>(transpose(fA))));
+    EXPECT_TRUE(all_equal(adjoint(A), Sparse<elt_t>(adjoint(fA))));
+  }
+
+  TEST(RSparseTest, TransposeLarge) {
+    test_sparse_transpose_large<double>();
+  }
+
+  TEST(CSparseTest, TransposeLarge) {
+    test_sparse_transpose_large<cdouble>();
+  }
+
+  template<typename elt_t>
+  void test_sparse_mmult(const Sparse<elt_t> &A, tensor::index n,
+                         double epsilon = 2*EPSILON) {
+    Tensor<elt_t> fA = full(A);
+    tensor::index rows = A.rows(), cols = A.columns();
+    {
+      Tensor<elt_t> B = Tensor<elt_t>::random(igen << cols);
+      EXPECT_TRUE(approx_eq(mmult(A, B), mmult(fA, B), epsilon));
+      Tensor<elt_t> C = Tensor<elt_t>::random(igen << rows);
+      EXPECT_TRUE(approx_eq(mmult(C, A), mmult(C, fA), epsilon));
+    }
+    {
+      Tensor<elt_t> B = Tensor<elt_t>::random(cols, n);
+      EXPECT_TRUE(approx_eq(mmult(A, B), mmult(fA, B), epsilon));
+      Tensor<elt_t> C = Tensor<elt_t>::random(n, rows);
+      EXPECT_TRUE(approx_eq(mmult(C, A), mmult(C, fA), epsilon));
+    }
+    {
+      Tensor<elt_t> B = Tensor<elt_t>::random(cols, 2, n);
+      EXPECT_TRUE(approx_eq(mmult(A, B), mmult(fA, B), epsilon));
+      Tensor<elt_t> C = Tensor<elt_t>::random(n, 2, rows);
+      EXPECT_TRUE(approx_eq(mmult(C, A), mmult(C, fA), epsilon));
+    }
+  }
+
+  template<typename elt_t>
+  void test_sparse_mmult_small(Tensor<elt_t> &t) {
+    // Dense products do not accept empty tensors
+    if (t.size() == 0)
+      return;
+    Sparse<elt_t> A = Sparse<elt_t>::random(t.rows(), t.columns());
+    for (tensor::index n = 1; n < 10; n++)
+      test_sparse_mmult(A, n);
+  }
+
+  TEST(RSparseTest, Mmult) {
+    test_over_fixed_rank_tensors<double>(test_sparse_mmult_small<double>, 2, 7);
+  }
+
+  TEST(CSparseTest, Mmult) {
+    test_over_fixed_rank_tensors<cdouble>(test_sparse_mmult_small<cdouble>, 2, 7);
+  }
+
+  template<typename elt_t>
+  void test_sparse_mmult_large() {
+    // Large enough to be split among threads
+    Sparse<elt_t> A = Sparse<elt_t>::random(500, 700, 0.3);
+    // Long sums are computed in different order
+    test_sparse_mmult(A, 6, 1e-12);
+    test_sparse_mmult(A, 200, 1e-12);
+  }
+
+  TEST(RSparseTest, MmultLarge) {
+    test_sparse_mmult_large<double>();
+  }
+
+  TEST(CSparseTest, MmultLarge) {
+    test_sparse_mmult_large<cdouble>();
+  }
+
+  template<typename t1, typename t2>
+  void test_sparse_sparse_mmult(tensor::index rows, tensor::index middle,
+                                tensor::index cols, double density) {
+    Sparse<t1> A = Sparse<t1>::random(rows, middle, density);
+    Sparse<t2> B = Sparse<t2>::random(middle, cols, density);
+    EXPECT_TRUE(approx_eq(full(mmult(A, B)), mmult(full(A), full(B)), 1e-12));
+    // Columns are ordered within each row
+    Sparse<t2> AB = mmult(A, B);
+    for (tensor::index i = 0; i < AB.rows(); i++)
+      for (tensor::index x = AB.priv_row_start()[i] + 1;
+           x < AB.priv_row_start()[i+1]; x++)
+        EXPECT_LT(AB.priv_column()[x-1], AB.priv_column()[x]);
+  }
+
+  template<typename t1, typename t2>
+  void test_sparse_sparse_mmult() {
+    for (tensor::index rows = 1; rows < 7; rows++)
+      for (tensor::index cols = 1; cols < 7; cols++)
+        test_sparse_sparse_mmult<t1,t2>(rows, 4, cols, 0.5);
+    // Large enough to be split among threads
+    test_sparse_sparse_mmult<t1,t2>(500, 700, 400, 0.05);
+  }
+
+  TEST(RSparseTest, SparseMmult) {
+    test_sparse_sparse_mmult<double,double>();
+  }
+
+  TEST(CSparseTest, SparseMmult) {
+    test_sparse_sparse_mmult<cdouble,cdouble>();
+    test_sparse_sparse_mmult<double,cdouble>();
+  }
+
+  /* [I I] * [C; -D] = C - D, which cancels exactly in the rows where C and D
+     are equal. Those zeros are not stored. */
+  template<typename elt_t>
+  void test_sparse_mmult_cancel(tensor::index n) {
+    Tensor<elt_t> C = Tensor<elt_t>::random(n, n);
+    Tensor<elt_t> D = C;
+    for (tensor::index i = 0; i < n; i += 2)
+      D.at(range(i), range()) = Tensor<elt_t>::random(1, n);
+    Tensor<elt_t> A = Tensor<elt_t>::zeros(n, 2*n);
+    A.at(range(0, n-1), range(0, n-1)) = Tensor<elt_t>::eye(n);
+    A.at(range(0, n-1), range(n, 2*n-1)) = Tensor<elt_t>::eye(n);
+    Tensor<elt_t> B = Tensor<elt_t>::zeros(2*n, n);
+    B.at(range(0, n-1), range()) = C;
+    B.at(range(n, 2*n-1), range()) = -D;
+    Sparse<elt_t> AB = mmult(Sparse<elt_t>(A), Sparse<elt_t>(B));
+    EXPECT_TRUE(all_equal(AB, Sparse<elt_t>(C - D)));
+    EXPECT_EQ(AB.length(), ((n + 1) / 2) * n);
+  }
+
+  TEST(RSparseTest, SparseMmultCancel) {
+    test_sparse_mmult_cancel<double>(5);
+    test_sparse_mmult_cancel<double>(400);
+  }
+
+  TEST(CSparseTest, SparseMmultCancel) {
+    test_sparse_mmult_cancel<cdouble>(5);
+    test_sparse_mmult_cancel<cdouble>(400);
+  }
+
+  TEST(CSparseTest, SparseMmultMixed) {
+    Sparse<cdouble> A = Sparse<cdouble>::random(20, 30);
+    Sparse<double> B = Sparse<double>::random(30, 10);
+    EXPECT_TRUE(approx_eq(full(mmult(A, B)), mmult(full(A), full(B))));
+    EXPECT_TRUE(all_equal(mmult(A, B), mmult(A, to_complex(B))));
+  }
+
+  //
+  // IN-PLACE ACCUMULATION AND PATTERN REUSE
+  //
+
+  template<typename elt_t>
+  const Sparse<elt_t> every_other_element(const Sparse<elt_t> &A) {
+    // A matrix with half of the elements of A
+    tensor::index n = A.length() / 2;
+    Indices rows(n), cols(n);
+    Tensor<elt_t> data = Tensor<elt_t>::random(n);
+    for (tensor::index i = 0, k = 0; i < A.rows(); i++) {
+      for (tensor::index x = A.priv_row_start()[i];
+           x < A.priv_row_start()[i+1]; x++) {
+        if ((x % 2) && k < n) {
+          rows.at(k) = i;
+          cols.at(k++) = A.priv_column()[x];
+        }
+      }
+    }
+    return Sparse<elt_t>(rows, cols, data, A.rows(), A.columns());
+  }
+
+  template<typename elt_t>
+  void test_sparse_axpy(tensor::index rows, tensor::index cols, double density) {
+    elt_t alpha = number_one<elt_t>() * 0.5;
+    Sparse<elt_t> A = Sparse<elt_t>::random(rows, cols, density);
+    {
+      // B is contained in A: A keeps its pattern and copies of A are unchanged
+      Sparse<elt_t> B = every_other_element(A);
+      Sparse<elt_t> C = A;
+      Tensor<elt_t> fA = full(A);
+      Tensor<elt_t> expected = fA + alpha * full(B);
+      axpy(C, alpha, B);
+      EXPECT_TRUE(approx_eq(full(C), expected));
+      EXPECT_EQ(A.priv_column().begin(), C.priv_column().begin());
+      EXPECT_TRUE(all_equal(full(A), fA));
+      C += B;
+      EXPECT_TRUE(approx_eq(full(C), expected + full(B)));
+    }
+    {
+      // General case
+      Sparse<elt_t> B = Sparse<elt_t>::random(rows, cols, density);
+      Sparse<elt_t> C = A;
+      axpy(C, alpha, B);
+      EXPECT_TRUE(approx_eq(full(C), full(A) + alpha * full(B)));
+    }
+    {
+      // Elements that cancel are dropped, as in A + B
+      Sparse<elt_t> B = every_other_element(A);
+      Sparse<elt_t> C = A + B;
+      C += -A;
+      EXPECT_TRUE(all_equal(C, (A + B) - A));
+      EXPECT_EQ(C.length(), B.length());
+      axpy(C, -number_one<elt_t>(), C);
+      EXPECT_EQ(C.length(), 0);
+    }
+  }
+
+  template<typename elt_t>
+  void test_sparse_axpy() {
+    for (tensor::index rows = 1; rows < 7; rows++)
+      for (tensor::index cols = 1; cols < 7; cols++)
+        test_sparse_axpy<elt_t>(rows, cols, 0.5);
+    test_sparse_axpy<elt_t>(500, 700, 0.3);
+  }
+
+  TEST(RSparseTest, Axpy) {
+    test_sparse_axpy<double>();
+  }
+
+  TEST(CSparseTest, Axpy) {
+    test_sparse_axpy<cdouble>();
+  }
+
+  template<typename elt_t>
+  void test_sparse_combination(tensor::index rows, tensor::index cols) {
+    Sparse<elt_t> H0 = Sparse<elt_t>::random(rows, cols);
+    Sparse<elt_t> H1 = Sparse<elt_t>::random(rows, cols);
+    SparseCombination<elt_t> H(H0, H1);
+    EXPECT_EQ(2, H.terms());
+    Sparse<elt_t> Ha, Hb;
+    for (int step = 0; step < 3; step++) {
+      elt_t f = number_one<elt_t>() * (0.3 * step - 0.2);
+      Sparse<elt_t> Ht = H(number_one<elt_t>(), f);
+      EXPECT_TRUE(approx_eq(full(Ht), full(H0) + f * full(H1)));
+      if (step == 0) Ha = Ht; else Hb = Ht;
+    }
+    // All results share the same structure
+    EXPECT_EQ(Ha.priv_column().begin(), Hb.priv_column().begin());
+    EXPECT_EQ(Ha.priv_row_start().begin(), Hb.priv_row_start().begin());
+    // More terms
+    Sparse<elt_t> H2 = Sparse<elt_t>::random(rows, cols);
+    H.add(H2);
+    Tensor<elt_t> c = Tensor<elt_t>::random(igen << 3);
+    EXPECT_TRUE(approx_eq(full(H(c)),
+                          c[0] * full(H0) + c[1] * full(H1) + c[2] * full(H2)));
+  }
+
+  template<typename elt_t>
+  void test_sparse_combination() {
+    for (tensor::index rows = 1; rows < 7; rows++)
+      for (tensor::index cols = 1; cols < 7; cols++)
+        test_sparse_combination<elt_t>(rows, cols);
+    test_sparse_combination<elt_t>(500, 700);
+  }
+
+  TEST(RSparseTest, Combination) {
+    test_sparse_combination<double>();
+  }
+
+  TEST(CSparseTest, Combination) {
+    test_sparse_combination<cdouble>();
+  }
+
+  template<typename elt_t>
+  void test_sparse_binop_large() {
+    // Large enough to be split among threads
+    Sparse<elt_t> A = Sparse<elt_t>::random(500, 700, 0.3);
+    Sparse<elt_t> B = Sparse<elt_t>::random(500, 700, 0.3);
+    EXPECT_TRUE(all_equal(A + B, Sparse<elt_t>(full(A) + full(B))));
+    EXPECT_TRUE(all_equal(A - B, Sparse<elt_t>(full(A) - full(B))));
+    EXPECT_TRUE(all_equal(A * B, Sparse<elt_t>(full(A) * full(B))));
+  }
+
+  TEST(RSparseTest, BinopLarge) {
+    test_sparse_binop_large<double>();
+  }
+
+  TEST(CSparseTest, BinopLarge) {
+    test_sparse_binop_large<cdouble>();
+  }
+
+  template<typename elt_t>
+  const Tensor<elt_t> dense_sum(const Tensor<elt_t> &A, int which) {
+    Tensor<elt_t> output(igen << A.dimension(1 - which));
+    output.fill_with_zeros();
+    for (tensor::index i = 0; i < A.rows(); i++)
+      for (tensor::index j = 0; j < A.columns(); j++)
+        output.at(which? i : j) += A(i,j);
+    return output;
+  }
+
+  template<typename elt_t>
+  void test_sparse_reduce(Tensor<elt_t> &t) {
+    tensor::index rows = t.rows(), cols = t.columns();
+    if (t.size() == 0)
+      return;
+    Sparse<elt_t> A = Sparse<elt_t>::random(rows, cols, 0.5);
+    Tensor<elt_t> fA = full(A);
+    for (int which = -rows + 1; which < cols; which++) {
+      Tensor<elt_t> d = take_diag(fA, which);
+      EXPECT_TRUE(all_equal(take_diag(A, which), d));
+      EXPECT_TRUE(all_equal(full(Sparse<elt_t>::diag(d, which, rows, cols)),
+                            diag(d, which, rows, cols)));
+    }
+    EXPECT_TRUE(all_equal(full(Sparse<elt_t>::diag(take_diag(fA))),
+                          diag(take_diag(fA))));
+    EXPECT_LE(abs(trace(A) - sum(take_diag(fA))), 1e-13);
+    EXPECT_LE(abs(sum(A) - sum(fA)), 1e-13);
+    EXPECT_LE(abs(norm2(A) - norm2(fA)), 1e-13);
+    EXPECT_LE(abs(matrix_norminf(A) - matrix_norminf(fA)), 1e-13);
+    EXPECT_TRUE(approx_eq(sum(A, 0), dense_sum(fA, 0)));
+    EXPECT_TRUE(approx_eq(sum(A, 1), dense_sum(fA, 1)));
+    EXPECT_TRUE(approx_eq(sum(A, -1), dense_sum(fA, 1)));
+  }
+
+  TEST(RSparseTest, Reduce) {
+    test_over_fixed_rank_tensors<double>(test_sparse_reduce<double>, 2, 7);
+  }
+
+  TEST(CSparseTest, Reduce) {
+    test_over_fixed_rank_tensors<cdouble>(test_sparse_reduce<cdouble>, 2, 7);
+  }
+
+  template<typename elt_t>
+  void test_sparse_reduce_large() {
+    // Large enough to be split among threads
+    Sparse<elt_t> A = Sparse<elt_t>::random(500, 700, 0.3);
+    Tensor<elt_t> fA = full(A);
+    EXPECT_TRUE(all_equal(take_diag(A, 3), take_diag(fA, 3)));
+    EXPECT_LE(abs(trace(A) - sum(take_diag(fA))), 1e-12);
+    EXPECT_LE(abs(matrix_norminf(A) - matrix_norminf(fA)), 1e-12);
+    EXPECT_TRUE(approx_eq(sum(A, 0), dense_sum(fA, 0), 1e-12));
+    EXPECT_TRUE(approx_eq(sum(A, 1), dense_sum(fA, 1), 1e-12));
+  }
+
+  TEST(RSparseTest, ReduceLarge) {
+    test_sparse_reduce_large<double>();
+  }
+
+  TEST(CSparseTest, ReduceLarge) {
+    test_sparse_reduce_large<cdouble>();
+  }
+
+  template<typename elt_t>
+  void test_sparse_view(Tensor<elt_t> &t) {
+    tensor::index rows = t.rows(), cols = t.columns();
+    Sparse<elt_t> A = Sparse<elt_t>::random(rows, cols, 0.5);
+    Tensor<elt_t> fA = full(A);
+    for (tensor::index first = 0; first <= rows; first++) {
+      for (tensor::index last = first; last <= rows; last++) {
+        SparseView<elt_t> V(A, first, last);
+        EXPECT_EQ(V.rows(), last - first);
+        EXPECT_EQ(V.columns(), cols);
+        // The view shares the elements of A
+        EXPECT_EQ(V.priv_column().begin(), A.priv_column().begin());
+        EXPECT_EQ(V.priv_data().begin(), A.priv_data().begin());
+        Sparse<elt_t> B(V);
+        EXPECT_EQ(V.length(), B.length());
+        if (first < last) {
+          Indices r = iota(first, last - 1);
+          EXPECT_TRUE(all_equal(B, take_rows(A, r)));
+          if (cols) {
+            EXPECT_TRUE(all_equal(full(B), fA(range(r), range())));
+            EXPECT_EQ(V(0, cols-1), fA(first, cols-1));
+            Tensor<elt_t> x = Tensor<elt_t>::random(cols, 3);
+            EXPECT_TRUE(approx_eq(mmult(V, x), mmult(full(B), x)));
+            Tensor<elt_t> y = Tensor<elt_t>::random(2, last - first);
+            EXPECT_TRUE(approx_eq(mmult(y, V), mmult(y, full(B))));
+          }
+        }
+      }
+    }
+  }
+
+  TEST(RSparseTest, View) {
+    test_over_fixed_rank_tensors<double>(test_sparse_view<double>, 2, 5);
+  }
+
+  TEST(CSparseTest, View) {
+    test_over_fixed_rank_tensors<cdouble>(test_sparse_view<cdouble>, 2, 5);
+  }
+
+  TEST(RSparseTest, ViewErrors) {
+    RSparse A = RSparse::random(4, 3);
+    ASSERT_DEATH(RSparseView(A, 2, 1), "SparseView");
+    ASSERT_DEATH(RSparseView(A, -1, 2), "SparseView");
+    ASSERT_DEATH(RSparseView(A, 0, 5), "SparseView");
+  }
+
+  template<typename elt_t>
+  void test_sparse_slice(Tensor<elt_t> &t) {
+    tensor::index rows = t.rows(), cols = t.columns();
+    if (t.size() == 0)
+      return;
+    Sparse<elt_t> A = Sparse<elt_t>::random(rows, cols, 0.5);
+    Tensor<elt_t> fA = full(A);
+    Indices r = iota(rows - 1, 0, -1);
+    Indices c = iota(0, cols - 1, 2);
+    Indices shuffled = igen << cols - 1 << 0 << cols / 2 << 0;
+    EXPECT_TRUE(all_equal(full(take_rows(A, r)), fA(range(r), range())));
+    EXPECT_TRUE(all_equal(full(take_columns(A, c)), fA(range(), range(c))));
+    EXPECT_TRUE(all_equal(full(take_columns(A, shuffled)),
+                          fA(range(), range(shuffled))));
+    EXPECT_TRUE(all_equal(full(submatrix(A, r, shuffled)),
+                          fA(range(r), range(shuffled))));
+  }
+
+  TEST(RSparseTest, Slice) {
+    test_over_fixed_rank_tensors<double>(test_sparse_slice<double>, 2, 7);
+  }
+
+  TEST(CSparseTest, Slice) {
+    test_over_fixed_rank_tensors<cdouble>(test_sparse_slice<cdouble>, 2, 7);
+  }
+
+  template<typename elt_t>
+  void test_sparse_view_large() {
+    // Large enough to be split among threads
+    Sparse<elt_t> A = Sparse<elt_t>::random(500, 700, 0.3);
+    Tensor<elt_t> x = Tensor<elt_t>::random(700, 2);
+    Tensor<elt_t> y = mmult(A, x);
+    SparseView<elt_t> V(A, 120, 480);
+    Indices r = iota(120, 479);
+    EXPECT_TRUE(approx_eq(mmult(V, x), Tensor<elt_t>(y(range(r), range())), 1e-12));
+    EXPECT_TRUE(all_equal(take_columns(Sparse<elt_t>(V), iota(699, 0, -1)),
+                          submatrix(A, r, iota(699, 0, -1))));
+  }
+
+  TEST(RSparseTest, ViewLarge) {
+    test_sparse_view_large<double>();
+  }
+
+  TEST(CSparseTest, ViewLarge) {
+    test_sparse_view_large<cdouble>();
+  }
+
+  template<typename elt_t>
+  const Sparse<elt_t> scrambled_grid(tensor::index L) {
+    // Laplacian of a L x L grid, with the sites in a scrambled order
+    tensor::index n = L * L;
+    Indices site(n), rows(n + 2 * L * (L - 1)), cols(rows.size());
+    for (tensor::index k = 0; k < n; k++)
+      site.at(k) = (k * 7919) % n;
+    tensor::index m = 0;
+    for (tensor::index x = 0; x < L; x++)
+      for (tensor::index y = 0; y < L; y++) {
+        tensor::index i = site[x + L * y];
+        if (x + 1 < L) {
+          rows.at(m) = i; cols.at(m++) = site[x + 1 + L * y];
+        }
+        if (y + 1 < L) {
+          rows.at(m) = site[x + L * (y + 1)]; cols.at(m++) = i;
+        }
+        rows.at(m) = i; cols.at(m++) = i;
+      }
+    Tensor<elt_t> data(igen << m);
+    data.fill_with(number_one<elt_t>());
+    return Sparse<elt_t>(rows, cols, data, n, n);
+  }
+
+  template<typename elt_t>
+  void test_sparse_rcm(tensor::index L) {
+    Sparse<elt_t> H = scrambled_grid<elt_t>(L);
+    Indices p = reverse_cuthill_mckee(H);
+    Indices q = inverse_permutation(p);
+    ASSERT_EQ(p.size(), H.rows());
+    for (tensor::index k = 0; k < (tensor::index)p.size(); k++)
+      EXPECT_EQ(q[p[k]], k);
+    Sparse<elt_t> Hp = permute(H, p);
+    EXPECT_TRUE(all_equal(full(Hp), full(H)(range(p), range(p))));
+    EXPECT_LE(bandwidth(Hp), L + 1);
+    EXPECT_GT(bandwidth(H), 2 * L);
+    // Products in the new order give the same vectors
+    Tensor<elt_t> x = Tensor<elt_t>::random(H.rows(), 2);
+    Tensor<elt_t> y = mmult(Hp, take_rows(x, p));
+    EXPECT_TRUE(approx_eq(take_rows(y, q), mmult(H, x)));
+  }
+
+  TEST(RSparseTest, ReverseCuthillMcKee) {
+    test_sparse_rcm<double>(5);
+    test_sparse_rcm<double>(40);
+  }
+
+  TEST(CSparseTest, ReverseCuthillMcKee) {
+    test_sparse_rcm<cdouble>(5);
+    test_sparse_rcm<cdouble>(40);
+  }
+
+  TEST(RSparseTest, InversePermutationErrors) {
+    ASSERT_DEATH(inverse_permutation(igen << 0 << 0), "permutation");
+    ASSERT_DEATH(inverse_permutation(igen << 1 << 2), "permutation");
+  }
+
+  TEST(RSparseTest, ReverseCuthillMcKeeComponents) {
+    // Disconnected blocks and isolated sites are all ordered
+    RSparse H = RSparse(igen << 0 << 5 << 2 << 7 << 4,
+                        igen << 5 << 0 << 7 << 2 << 4,
+                        rgen << 1.0 << 1.0 << 1.0 << 1.0 << 1.0, 9, 9);
+    Indices p = reverse_cuthill_mckee(H);
+    EXPECT_EQ(bandwidth(permute(H, p)), 1);
+    EXPECT_TRUE(all_equal(full(permute(H, p)), full(H)(range(p), range(p))));
+    EXPECT_EQ(reverse_cuthill_mckee(RSparse(0, 0)).size(), 0);
+  }
+
+  TEST(CSparseTest, MmultRealSparse) {
+    // Real matrices act on complex tensors without becoming complex
+    for (int n = 1; n < 8; n++) {
+      RSparse A = RSparse::random(n, n + 2, 0.5);
+      CSparse cA = A;
+      CTensor x = CTensor::random(n + 2, 3);
+      CTensor y = CTensor::random(4, n);
+      EXPECT_TRUE(approx_eq(mmult(A, x), mmult(cA, x)));
+      EXPECT_TRUE(approx_eq(mmult(y, A), mmult(y, cA)));
+    }
+    RSparse A = RSparse::random(500, 700, 0.3);
+    CSparse cA = A;
+    CTensor x = CTensor::random(700, 5);
+    CTensor y = CTensor::random(3, 500);
+    EXPECT_TRUE(approx_eq(mmult(A, x), mmult(cA, x), 1e-12));
+    EXPECT_TRUE(approx_eq(mmult(A, x(range(), range(0))), mmult(cA, x(range(), range(0))), 1e-12));
+    EXPECT_TRUE(approx_eq(mmult(y, A), mmult(y, cA), 1e-12));
+    MatrixMap<RSparse, CTensor> map(A);
+    EXPECT_TRUE(approx_eq(map(x), mmult(cA, x), 1e-12));
+  }
+
 } // namespace test
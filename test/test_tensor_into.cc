@@ -0,0 +1,161 @@
+// -*- mode: c++; fill-column: 80; c-basic-offset: 2; indent-tabs-mode: nil -*-
+/*
+    Copyright (c) 2010 Juan Jose Garcia Ripoll
+
+    Tensor is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published
+    by the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Library General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "loops.h"
+#include <gtest/gtest.h>
+#include <tensor/tensor.h>
+#include <tensor/linalg.h>
+
+namespace tensor_test {
+
+  //////////////////////////////////////////////////////////////////////
+  // OPERATIONS THAT REUSE THE STORAGE OF THEIR OUTPUT
+  //
+
+  template<typename elt_t>
+  void test_into_reuses(const Tensor<elt_t> &A, const Tensor<elt_t> &B) {
+    // All operations produce the right result, and a second call with
+    // an output of the right size does not reallocate it.
+    Tensor<elt_t> C;
+    const elt_t *p;
+
+    permute_into(C, A, 0, 2);
+    EXPECT_TRUE(all_equal(C, permute(A, 0, 2)));
+    p = C.begin_const();
+    permute_into(C, B, 0, 2);
+    EXPECT_EQ(p, C.begin_const());
+    EXPECT_TRUE(all_equal(C, permute(B, 0, 2)));
+
+    Tensor<elt_t> M = reshape(A, A.dimension(0), A.size() / A.dimension(0));
+    Tensor<elt_t> N = reshape(B, B.dimension(0), B.size() / B.dimension(0));
+    transpose_into(C, M);
+    p = C.begin_const();
+    transpose_into(C, N);
+    EXPECT_EQ(p, C.begin_const());
+    EXPECT_TRUE(all_equal(C, transpose(N)));
+    adjoint_into(C, M);
+    EXPECT_EQ(p, C.begin_const());
+    EXPECT_TRUE(all_equal(C, adjoint(M)));
+
+    exp_into(C, A);
+    p = C.begin_const();
+    exp_into(C, B);
+    EXPECT_EQ(p, C.begin_const());
+    EXPECT_TRUE(all_equal(C, exp(B)));
+
+    plus_into(C, A, B);
+    EXPECT_EQ(p, C.begin_const());
+    EXPECT_TRUE(all_equal(C, A + B));
+    times_into(C, A, number_one<elt_t>() * 2.0);
+    EXPECT_EQ(p, C.begin_const());
+    EXPECT_TRUE(all_equal(C, A * 2.0));
+    minus_into(C, C, B);
+    EXPECT_EQ(p, C.begin_const());
+    EXPECT_TRUE(all_equal(C, A * 2.0 - B));
+
+    Tensor<elt_t> v = Tensor<elt_t>::random(A.dimension(1));
+    scale_into(C, A, 1, v);
+    EXPECT_EQ(p, C.begin_const());
+    EXPECT_TRUE(all_equal(C, scale(A, 1, v)));
+
+    Tensor<elt_t> a = Tensor<elt_t>::random(2, 3);
+    Tensor<elt_t> b = Tensor<elt_t>::random(3, 2);
+    kron_into(C, a, b);
+    p = C.begin_const();
+    kron_into(C, b, a);
+    EXPECT_EQ(p, C.begin_const());
+    EXPECT_TRUE(all_equal(C, kron(b, a)));
+
+    mmult_into(C, a, b);
+    p = C.begin_const();
+    mmult_into(C, b, a);
+    mmult_into(C, a, b);
+    EXPECT_EQ(p, C.begin_const());
+    EXPECT_TRUE(all_equal(C, mmult(a, b)));
+
+    // Aliasing of input and output is allowed
+    Tensor<elt_t> D = a;
+    mmult_into(D, D, b);
+    EXPECT_TRUE(all_equal(D, mmult(a, b)));
+    D = M;
+    transpose_into(D, D);
+    EXPECT_TRUE(all_equal(D, transpose(M)));
+
+    // ... even when the aliased argument shares its buffer
+    D = A;
+    Tensor<elt_t> keep = D;
+    exp_into(D, D);
+    EXPECT_TRUE(all_equal(keep, A));
+    EXPECT_TRUE(all_equal(D, exp(A)));
+    D = B;
+    keep = D;
+    plus_into(D, A, D);
+    EXPECT_TRUE(all_equal(keep, B));
+    EXPECT_TRUE(all_equal(D, A + B));
+
+    // The output always takes the shape of the first argument
+    D = reshape(B, B.size());
+    plus_into(D, A, D);
+    EXPECT_TRUE(all_equal(D.dimensions(), A.dimensions()));
+    EXPECT_TRUE(all_equal(D, A + B));
+  }
+
+  template<typename elt_t>
+  void test_linalg_into(int n) {
+    Tensor<elt_t> A = Tensor<elt_t>::random(n, n);
+    A = A + adjoint(A);
+    RTensor s;
+    Tensor<elt_t> U, V;
+    linalg::eig_sym_into(s, A, &U);
+    const double *ps = s.begin_const();
+    const elt_t *pU = U.begin_const();
+    linalg::eig_sym_into(s, A, &U);
+    EXPECT_EQ(ps, s.begin_const());
+    EXPECT_EQ(pU, U.begin_const());
+    EXPECT_TRUE(approx_eq(s, linalg::eig_sym(A), 1e-12));
+    EXPECT_TRUE(approx_eq(mmult(A, U), scale(U, -1, s), 1e-12));
+
+    linalg::svd_into(s, A, &U, &V);
+    ps = s.begin_const();
+    pU = U.begin_const();
+    const elt_t *pV = V.begin_const();
+    linalg::svd_into(s, A, &U, &V);
+    EXPECT_EQ(ps, s.begin_const());
+    EXPECT_EQ(pU, U.begin_const());
+    EXPECT_EQ(pV, V.begin_const());
+    EXPECT_TRUE(approx_eq(A, mmult(scale(U, -1, s), V), 1e-12));
+  }
+
+  TEST(TensorInto, RTensor) {
+    test_into_reuses(RTensor::random(2, 3, 4), RTensor::random(2, 3, 4));
+  }
+
+  TEST(TensorInto, CTensor) {
+    test_into_reuses(CTensor::random(2, 3, 4), CTensor::random(2, 3, 4));
+  }
+
+  TEST(TensorInto, RTensorLinalg) {
+    test_linalg_into<double>(5);
+  }
+
+  TEST(TensorInto, CTensorLinalg) {
+    test_linalg_into<cdouble>(5);
+  }
+
+} // namespace tensor_test
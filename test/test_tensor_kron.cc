@@ -120,5 +120,60 @@ namespace tensor_test {
     test_over_fixed_rank_pairs<cdouble>(test_slow_kron<cdouble>, 2);
   }
 
+  template<typename elt_t>
+  void test_large_kron()
+  {
+    // Large enough to be split among threads
+    Tensor<elt_t> a = Tensor<elt_t>::random(30, 20);
+    Tensor<elt_t> b = Tensor<elt_t>::random(15, 12);
+    ASSERT_TRUE(approx_eq(slow_kron(a,b), kron(a,b)));
+    Tensor<elt_t> c = Tensor<elt_t>::random(7);
+    kron_into(c, a, b);
+    ASSERT_TRUE(approx_eq(slow_kron(a,b), c));
+  }
+
+  TEST(RTensorKronTest, LargeKron) {
+    test_large_kron<double>();
+  }
+
+  TEST(CTensorKronTest, LargeKron) {
+    test_large_kron<cdouble>();
+  }
+
+  //
+  // SUM OF OPERATORS ON DIFFERENT SPACES
+  //
+
+  template<typename elt_t>
+  void test_kron2_sum(Tensor<elt_t> &a, Tensor<elt_t> &b)
+  {
+    a.randomize();
+    b.randomize();
+    Tensor<elt_t> expected =
+      slow_kron(Tensor<elt_t>::eye(a.rows(), a.columns()), b) +
+      slow_kron(a, Tensor<elt_t>::eye(b.rows(), b.columns()));
+    ASSERT_TRUE(all_equal(expected, kron2_sum(a,b)));
+  }
+
+  template<typename elt_t>
+  void test_kron2_sum_vector(Tensor<elt_t> &a, Tensor<elt_t> &b)
+  {
+    a.randomize();
+    b.randomize();
+    Tensor<elt_t> expected =
+      kron(Tensor<elt_t>::ones(igen << a.size()), b) +
+      kron(a, Tensor<elt_t>::ones(igen << b.size()));
+    ASSERT_TRUE(all_equal(expected, kron2_sum(a,b)));
+  }
+
+  TEST(RTensorKronTest, Kron2Sum) {
+    test_over_fixed_rank_pairs<double>(test_kron2_sum<double>, 2);
+    test_over_fixed_rank_pairs<double>(test_kron2_sum_vector<double>, 1);
+  }
+
+  TEST(CTensorKronTest, Kron2Sum) {
+    test_over_fixed_rank_pairs<cdouble>(test_kron2_sum<cdouble>, 2);
+    test_over_fixed_rank_pairs<cdouble>(test_kron2_sum_vector<cdouble>, 1);
+  }
 
 } // namespace tensor_test